@@ -0,0 +1,127 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* Tester library                                                           */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* The MIT License (MIT)                                                    */
+/*                                                                          */
+/* Permission is hereby granted, free of charge, to any person obtaining    */
+/* a copy of this software and associated documentation files (the          */
+/* "Software"), to deal in the Software without restriction, including      */
+/* without limitation the rights to use, copy, modify, merge, publish,      */
+/* distribute, sublicense, and/or sell copies of the Software, and to       */
+/* permit persons to whom the Software is furnished to do so, subject to    */
+/* the following conditions:                                                */
+/*                                                                          */
+/* The above copyright notice and this permission notice shall be included  */
+/* in all copies or substantial portions of the Software.                   */
+/*                                                                          */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  */
+/* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/**
+ * Measures throughput of array assertions compared to memcmp and to one
+ * ASSERT per element.
+ */
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
+#include "../tester.hpp"
+
+// C++
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/// Number of elements.
+static const std::size_t SIZE = 16 * 1024 * 1024;
+
+/// Number of repetitions.
+static const int REPEAT = 20;
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Returns time difference in seconds.
+ */
+static double elapsed(tester::time_point start, tester::time_point stop)
+{
+#ifdef CXX11
+    return std::chrono::duration<double>(stop - start).count();
+#else
+    return static_cast<double>(stop - start) / CLOCKS_PER_SEC;
+#endif
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints throughput of reading both arrays.
+ */
+static void report(const char* name, double seconds, std::size_t bytes)
+{
+    std::cout << name << ": " << (2.0 * bytes * REPEAT / seconds / 1e9) << " GB/s\n";
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Main function.
+ */
+int main()
+{
+    std::vector<float> a(SIZE), b(SIZE);
+
+    for (std::size_t i = 0; i < SIZE; ++i)
+        a[i] = b[i] = static_cast<float>(i);
+
+    const std::size_t bytes = SIZE * sizeof(float);
+    tester::time_point start;
+    int diff = 0;
+
+    // Reference, volatile pointer prevents hoisting out of the loop
+    const float* volatile ptr = &a[0];
+
+    start = tester::get_time();
+    for (int r = 0; r < REPEAT; ++r)
+        diff |= std::memcmp(ptr, &b[0], bytes);
+    report("memcmp           ", elapsed(start, tester::get_time()), bytes);
+
+    start = tester::get_time();
+    for (int r = 0; r < REPEAT; ++r)
+        ASSERT_ARRAY_EQ(&a[0], &b[0], SIZE);
+    report("ASSERT_ARRAY_EQ  ", elapsed(start, tester::get_time()), bytes);
+
+    start = tester::get_time();
+    for (int r = 0; r < REPEAT; ++r)
+        ASSERT_ARRAY_NEAR(&a[0], &b[0], SIZE, 1e-6);
+    report("ASSERT_ARRAY_NEAR", elapsed(start, tester::get_time()), bytes);
+
+    start = tester::get_time();
+    for (int r = 0; r < REPEAT; ++r)
+        for (std::size_t i = 0; i < SIZE; ++i)
+            ASSERT_EQ(a[i], b[i]);
+    report("ASSERT_EQ loop   ", elapsed(start, tester::get_time()), bytes);
+
+    return diff;
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,119 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* Tester library                                                           */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* The MIT License (MIT)                                                    */
+/*                                                                          */
+/* Permission is hereby granted, free of charge, to any person obtaining    */
+/* a copy of this software and associated documentation files (the          */
+/* "Software"), to deal in the Software without restriction, including      */
+/* without limitation the rights to use, copy, modify, merge, publish,      */
+/* distribute, sublicense, and/or sell copies of the Software, and to       */
+/* permit persons to whom the Software is furnished to do so, subject to    */
+/* the following conditions:                                                */
+/*                                                                          */
+/* The above copyright notice and this permission notice shall be included  */
+/* in all copies or substantial portions of the Software.                   */
+/*                                                                          */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  */
+/* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/**
+ * Measures cost of passing assertions. Compare results of the library and
+ * the header-only build.
+ */
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
+#include "../tester.hpp"
+
+// C++
+#include <iostream>
+#include <vector>
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/// Number of elements.
+static const std::size_t SIZE = 1024 * 1024;
+
+/// Number of repetitions.
+static const int REPEAT = 100;
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Returns time difference in seconds.
+ */
+static double elapsed(tester::time_point start, tester::time_point stop)
+{
+#ifdef CXX11
+    return std::chrono::duration<double>(stop - start).count();
+#else
+    return static_cast<double>(stop - start) / CLOCKS_PER_SEC;
+#endif
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Assertion heavy test.
+ */
+TEST(assertions)
+{
+    std::vector<int> values(SIZE);
+
+    for (std::size_t i = 0; i < SIZE; ++i)
+        values[i] = static_cast<int>(i);
+
+    for (int r = 0; r < REPEAT; ++r)
+    {
+        for (std::size_t i = 0; i < SIZE; ++i)
+        {
+            ASSERT_EQ(values[i], static_cast<int>(i));
+            EXPECT_NEQ(values[i], -1);
+        }
+    }
+}
+
+/* ************************************************************************ */
+
+void tests_run()
+{
+    TEST_RUN(assertions);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Main function.
+ */
+int main()
+{
+    const tester::time_point start = tester::get_time();
+    const int res = tester::run_tests(tests_run);
+    const double seconds = elapsed(start, tester::get_time());
+
+    std::cout << "Time per assertion: "
+        << (seconds * 1e9 / tester::assertion_count) << " ns\n";
+
+    return res;
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,306 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* Tester library                                                           */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* The MIT License (MIT)                                                    */
+/*                                                                          */
+/* Permission is hereby granted, free of charge, to any person obtaining    */
+/* a copy of this software and associated documentation files (the          */
+/* "Software"), to deal in the Software without restriction, including      */
+/* without limitation the rights to use, copy, modify, merge, publish,      */
+/* distribute, sublicense, and/or sell copies of the Software, and to       */
+/* permit persons to whom the Software is furnished to do so, subject to    */
+/* the following conditions:                                                */
+/*                                                                          */
+/* The above copyright notice and this permission notice shall be included  */
+/* in all copies or substantial portions of the Software.                   */
+/*                                                                          */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  */
+/* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/**
+ * Measures overhead of the library itself: running tests, passing and
+ * failing assertions, printing results and scaling with tree shape.
+ *
+ * Results are written as JSON to the standard output or to the file given
+ * as the first argument.
+ */
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
+#include "../tester.hpp"
+
+// C++
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Stream buffer that discards everything.
+ */
+class null_buffer : public std::streambuf
+{
+
+// Protected Operations
+protected:
+
+
+    int overflow(int c)
+    {
+        return traits_type::not_eof(c);
+    }
+
+
+    std::streamsize xsputn(const char*, std::streamsize n)
+    {
+        return n;
+    }
+
+};
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/// Number of synthetic tests.
+static const unsigned int COUNT = 1000000;
+
+/// Tree depth.
+static unsigned int tree_depth;
+
+/// Tree width.
+static unsigned int tree_width;
+
+/// Current tree level.
+static unsigned int tree_level;
+
+/// Number of assertions per test, volatile prevents folding the loops.
+static volatile unsigned int assert_count;
+
+/// JSON results.
+static std::ostringstream results;
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Returns time difference in seconds.
+ */
+static double elapsed(tester::time_point start, tester::time_point stop)
+{
+#ifdef CXX11
+    return std::chrono::duration<double>(stop - start).count();
+#else
+    return static_cast<double>(stop - start) / CLOCKS_PER_SEC;
+#endif
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Stores benchmark result.
+ *
+ * @param name    Benchmark name.
+ * @param count   Number of operations.
+ * @param seconds Measured time.
+ */
+static void report(const std::string& name, unsigned long count, double seconds)
+{
+    if (results.tellp() > 0)
+        results << ",\n";
+
+    results << "    {\"name\": \"" << name << "\", \"count\": " << count
+        << ", \"seconds\": " << seconds << ", \"ns_per_op\": "
+        << (seconds * 1e9 / count) << "}";
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Empty test.
+ */
+TEST(empty)
+{
+    // Nothing to do
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Tree node test, runs `tree_width` children up to `tree_depth`.
+ */
+TEST(node)
+{
+    if (tree_level == tree_depth)
+        return;
+
+    tree_level++;
+
+    for (unsigned int i = 0; i < tree_width; ++i)
+        TEST_RUN(node);
+
+    tree_level--;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Test with passing assertions.
+ */
+TEST(passing)
+{
+    for (unsigned int i = 0; i < assert_count; ++i)
+        ASSERT(i < assert_count);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Test with failing assertion.
+ */
+TEST(failing)
+{
+    ASSERT(assert_count == 0);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Test with failing expectations.
+ */
+TEST(expecting)
+{
+    for (unsigned int i = 0; i < assert_count; ++i)
+        EXPECT(i >= assert_count);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Runs test `count` times.
+ */
+static double measure(tester::test_func test, const std::string& name, unsigned int count)
+{
+    tester::start();
+
+    for (unsigned int i = 0; i < count; ++i)
+        tester::run_test(test, name);
+
+    tester::stop();
+
+    return elapsed(tester::start_time, tester::stop_time);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Measures tree of tests.
+ */
+static void measure_tree(unsigned int depth, unsigned int width)
+{
+    tree_depth = depth;
+    tree_width = width;
+    tree_level = 0;
+
+    // Number of tests without root
+    unsigned long count = 0;
+    unsigned long level = 1;
+    for (unsigned int i = 0; i < depth; ++i)
+    {
+        level *= width;
+        count += level;
+    }
+
+    tester::start();
+    TEST_RUN(node);
+    tester::stop();
+
+    std::ostringstream name;
+    name << "tree_depth_" << depth << "_width_" << width;
+    report(name.str(), count, elapsed(tester::start_time, tester::stop_time));
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Main function.
+ */
+int main(int argc, char** argv)
+{
+    null_buffer null;
+    std::streambuf* out = std::cout.rdbuf(&null);
+    std::streambuf* err = std::cerr.rdbuf(&null);
+
+    // Test run overhead
+    report("run_test", COUNT, measure(TEST_NAME(empty), "empty", COUNT));
+
+    // Tree shapes with about 1M tests
+    measure_tree(1, 1000000);
+    measure_tree(2, 1000);
+    measure_tree(3, 100);
+    measure_tree(6, 10);
+    measure_tree(20, 2);
+
+    // Passing assertions
+    assert_count = 100 * COUNT;
+    report("assert_pass", assert_count, measure(TEST_NAME(passing), "passing", 1));
+
+    // Failing assertions
+    assert_count = 1;
+    report("assert_fail", COUNT, measure(TEST_NAME(failing), "failing", COUNT));
+
+    // Failing expectations, all stored
+    assert_count = COUNT;
+    tester::expect_limit = COUNT;
+    report("expect_fail", COUNT, measure(TEST_NAME(expecting), "expecting", 1));
+
+    // Failing expectations over limit
+    tester::expect_limit = 100;
+    report("expect_fail_overflow", COUNT, measure(TEST_NAME(expecting), "expecting", 1));
+
+    // Printing results with errors
+    tester::expect_limit = COUNT;
+    measure(TEST_NAME(expecting), "expecting", 1);
+    const tester::time_point start = tester::get_time();
+    tester::print_results();
+    report("print_results", tester::errors.size(), elapsed(start, tester::get_time()));
+
+    std::cout.rdbuf(out);
+    std::cerr.rdbuf(err);
+
+    const std::string json = "{\n  \"benchmarks\": [\n" + results.str() + "\n  ]\n}\n";
+
+    if (argc > 1)
+    {
+        std::ofstream file(argv[1]);
+        file << json;
+    }
+    else
+    {
+        std::cout << json;
+    }
+
+    return 0;
+}
+
+/* ************************************************************************ */
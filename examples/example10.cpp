@@ -0,0 +1,85 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* Tester library                                                           */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* The MIT License (MIT)                                                    */
+/*                                                                          */
+/* Permission is hereby granted, free of charge, to any person obtaining    */
+/* a copy of this software and associated documentation files (the          */
+/* "Software"), to deal in the Software without restriction, including      */
+/* without limitation the rights to use, copy, modify, merge, publish,      */
+/* distribute, sublicense, and/or sell copies of the Software, and to       */
+/* permit persons to whom the Software is furnished to do so, subject to    */
+/* the following conditions:                                                */
+/*                                                                          */
+/* The above copyright notice and this permission notice shall be included  */
+/* in all copies or substantial portions of the Software.                   */
+/*                                                                          */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  */
+/* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/**
+ * Tests in this example fail on purpose to show failure context. Values
+ * added by SCOPED_TRACE and messages added by INFO are printed with each
+ * failure in their scope.
+ */
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <string>
+
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
+#include "../tester.hpp"
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Example 10 test
+ */
+TEST(example10)
+{
+    const std::string names[] = { "first", "second", "third" };
+
+    for (int i = 0; i < 3; ++i)
+    {
+        SCOPED_TRACE(i);
+
+        // Message is formatted only for the failure
+        INFO("name " << names[i] << " has " << names[i].length() << " characters");
+        EXPECT_NEQ(names[i].length(), 6u);
+    }
+}
+
+/* ************************************************************************ */
+
+void tests_run()
+{
+    TEST_RUN(example10);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Main function.
+ */
+int main()
+{
+    return tester::run_tests(tests_run);
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,125 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* Tester library                                                           */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* The MIT License (MIT)                                                    */
+/*                                                                          */
+/* Permission is hereby granted, free of charge, to any person obtaining    */
+/* a copy of this software and associated documentation files (the          */
+/* "Software"), to deal in the Software without restriction, including      */
+/* without limitation the rights to use, copy, modify, merge, publish,      */
+/* distribute, sublicense, and/or sell copies of the Software, and to       */
+/* permit persons to whom the Software is furnished to do so, subject to    */
+/* the following conditions:                                                */
+/*                                                                          */
+/* The above copyright notice and this permission notice shall be included  */
+/* in all copies or substantial portions of the Software.                   */
+/*                                                                          */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  */
+/* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/**
+ * Test output is printed with the test result. With --capture only output
+ * of failed tests is kept. Output of threads that don't run a test goes
+ * directly to the standard output, even if they outlive the test that
+ * started them.
+ */
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C
+#include <cstdio>
+
+// C++
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
+#include "../tester.hpp"
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/// Background thread started by a test.
+static std::thread background;
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Example 11.1 test
+ */
+TEST(example11_print)
+{
+    std::cout << "Printed by std::cout" << std::endl;
+    std::printf("Printed by printf\n");
+
+    ASSERT(true);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 11.2 test
+ */
+TEST(example11_background)
+{
+    // Thread writes after the test finished
+    background = std::thread([] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::cout << "Printed by background thread" << std::endl;
+    });
+
+    ASSERT(background.joinable());
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 11.3 test
+ */
+TEST(example11_wait)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    ASSERT(true);
+}
+
+/* ************************************************************************ */
+
+void tests_run()
+{
+    TEST_RUN(example11_print);
+    TEST_RUN(example11_background);
+    TEST_RUN(example11_wait);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Main function.
+ */
+int main(int argc, char** argv)
+{
+    const int result = tester::run_tests(argc, argv, tests_run);
+    background.join();
+
+    return result;
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,111 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* Tester library                                                           */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* The MIT License (MIT)                                                    */
+/*                                                                          */
+/* Permission is hereby granted, free of charge, to any person obtaining    */
+/* a copy of this software and associated documentation files (the          */
+/* "Software"), to deal in the Software without restriction, including      */
+/* without limitation the rights to use, copy, modify, merge, publish,      */
+/* distribute, sublicense, and/or sell copies of the Software, and to       */
+/* permit persons to whom the Software is furnished to do so, subject to    */
+/* the following conditions:                                                */
+/*                                                                          */
+/* The above copyright notice and this permission notice shall be included  */
+/* in all copies or substantial portions of the Software.                   */
+/*                                                                          */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  */
+/* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/**
+ * Tests can be skipped by a condition or by themselves. Flaky tests listed
+ * in a quarantine file (--quarantine=quarantine12.txt) are run but their
+ * failures don't fail the run.
+ */
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
+#include "../tester.hpp"
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Example 12.1 test
+ */
+TEST(example12_feature)
+{
+    const bool supported = false;
+
+    // Test stops here
+    if (!supported)
+        SKIP("not supported");
+
+    ASSERT(supported);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 12.2 test
+ */
+TEST(example12_wide)
+{
+    ASSERT_EQ(sizeof(void*), 8u);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 12.3 test, it fails on purpose
+ */
+TEST(example12_flaky)
+{
+    ASSERT(false);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 12 test
+ */
+TEST(example12)
+{
+    TEST_RUN(example12_feature);
+    TEST_RUN_IF(sizeof(void*) == 8, example12_wide);
+    TEST_RUN(example12_flaky);
+}
+
+/* ************************************************************************ */
+
+void tests_run()
+{
+    TEST_RUN(example12);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Main function.
+ */
+int main(int argc, char** argv)
+{
+    return tester::run_tests(argc, argv, tests_run);
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,123 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* Tester library                                                           */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* The MIT License (MIT)                                                    */
+/*                                                                          */
+/* Permission is hereby granted, free of charge, to any person obtaining    */
+/* a copy of this software and associated documentation files (the          */
+/* "Software"), to deal in the Software without restriction, including      */
+/* without limitation the rights to use, copy, modify, merge, publish,      */
+/* distribute, sublicense, and/or sell copies of the Software, and to       */
+/* permit persons to whom the Software is furnished to do so, subject to    */
+/* the following conditions:                                                */
+/*                                                                          */
+/* The above copyright notice and this permission notice shall be included  */
+/* in all copies or substantial portions of the Software.                   */
+/*                                                                          */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  */
+/* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   */
+/*                                                                          */
+/* ************************************************************************ */
+
+/**
+ * Tests in this example fail on purpose to show array assertion reports.
+ * Sizes are not multiples of the vector width so the differing elements
+ * are found by the tail loops of the vectorized comparison.
+ */
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
+#include "../tester.hpp"
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Example 14 bytes test
+ */
+TEST(example14_bytes)
+{
+    // 64 bytes are compared at once with AVX2 and 16 bytes with SSE2
+    unsigned char lhs[67];
+    unsigned char rhs[67];
+
+    for (int i = 0; i < 67; ++i)
+        lhs[i] = rhs[i] = static_cast<unsigned char>(i);
+
+    rhs[65] = 0;
+
+    ASSERT_ARRAY_EQ(lhs, rhs, 67);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 14 floats test
+ */
+TEST(example14_floats)
+{
+    // 8 floats are compared at once with AVX2 and 4 floats with SSE2
+    float lhs[11];
+    float rhs[11];
+
+    for (int i = 0; i < 11; ++i)
+        lhs[i] = rhs[i] = static_cast<float>(i);
+
+    // One element differs in the vectorized part and one in the tail
+    rhs[2] = 3;
+    rhs[10] = 10.5f;
+
+    ASSERT_ARRAY_NEAR(lhs, rhs, 11, 0.25f);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 14 doubles test
+ */
+TEST(example14_doubles)
+{
+    // 4 doubles are compared at once with AVX2 and 2 doubles with SSE2
+    double lhs[7];
+    double rhs[7];
+
+    for (int i = 0; i < 7; ++i)
+        lhs[i] = rhs[i] = i;
+
+    rhs[6] = 8;
+
+    ASSERT_ARRAY_NEAR(lhs, rhs, 7, 0.25);
+}
+
+/* ************************************************************************ */
+
+void tests_run()
+{
+    TEST_RUN(example14_bytes);
+    TEST_RUN(example14_floats);
+    TEST_RUN(example14_doubles);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Main function.
+ */
+int main()
+{
+    return tester::run_tests(tests_run);
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,149 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* Tester library                                                           */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* The MIT License (MIT)                                                    */
+/*                                                                          */
+/* Permission is hereby granted, free of charge, to any person obtaining    */
+/* a copy of this software and associated documentation files (the          */
+/* "Software"), to deal in the Software without restriction, including      */
+/* without limitation the rights to use, copy, modify, merge, publish,      */
+/* distribute, sublicense, and/or sell copies of the Software, and to       */
+/* permit persons to whom the Software is furnished to do so, subject to    */
+/* the following conditions:                                                */
+/*                                                                          */
+/* The above copyright notice and this permission notice shall be included  */
+/* in all copies or substantial portions of the Software.                   */
+/*                                                                          */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  */
+/* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   */
+/*                                                                          */
+/* ************************************************************************ */
+
+/**
+ * Sibling tests are run in random order with --shuffle. TEST_ISOLATION
+ * checks that two tests don't depend on their order. The checker test
+ * depends on state left by the setter test, so this example fails on
+ * purpose.
+ */
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
+#include "../tester.hpp"
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/// State shared by the setter and the checker test.
+static bool initialized = false;
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Example 15.1 test
+ */
+TEST(example15_sub1_1)
+{
+    ASSERT(true);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 15.1 test
+ */
+TEST(example15_sub1_2)
+{
+    ASSERT(true);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 15.1 test
+ */
+TEST(example15_sub1)
+{
+    TEST_RUN(example15_sub1_1);
+    TEST_RUN(example15_sub1_2);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 15.2 test
+ */
+TEST(example15_sub2)
+{
+    ASSERT(true);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 15.3 test, it changes the shared state
+ */
+TEST(example15_setter)
+{
+    initialized = true;
+    ASSERT(initialized);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 15.4 test, it passes only before the setter test
+ */
+TEST(example15_checker)
+{
+    ASSERT(!initialized);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 15 test
+ */
+TEST(example15)
+{
+    TEST_RUN(example15_sub1);
+    TEST_RUN(example15_sub2);
+
+    // Independent tests
+    TEST_ISOLATION(example15_sub1_1, example15_sub2);
+
+    // Order dependency is reported
+    TEST_ISOLATION(example15_setter, example15_checker);
+}
+
+/* ************************************************************************ */
+
+void tests_run()
+{
+    TEST_RUN(example15);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Main function.
+ */
+int main(int argc, char** argv)
+{
+    return tester::run_tests(argc, argv, tests_run);
+}
+
+/* ************************************************************************ */
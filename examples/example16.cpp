@@ -0,0 +1,102 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* Tester library                                                           */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* The MIT License (MIT)                                                    */
+/*                                                                          */
+/* Permission is hereby granted, free of charge, to any person obtaining    */
+/* a copy of this software and associated documentation files (the          */
+/* "Software"), to deal in the Software without restriction, including      */
+/* without limitation the rights to use, copy, modify, merge, publish,      */
+/* distribute, sublicense, and/or sell copies of the Software, and to       */
+/* permit persons to whom the Software is furnished to do so, subject to    */
+/* the following conditions:                                                */
+/*                                                                          */
+/* The above copyright notice and this permission notice shall be included  */
+/* in all copies or substantial portions of the Software.                   */
+/*                                                                          */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  */
+/* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   */
+/*                                                                          */
+/* ************************************************************************ */
+
+/**
+ * Lambda tests can use locals of the test that runs them. They're run in
+ * place even with --shuffle while sibling test functions are run in random
+ * order after the body of their parent test.
+ */
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <vector>
+
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
+#include "../tester.hpp"
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Example 16.1 test
+ */
+TEST(example16_sub1)
+{
+    ASSERT(true);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 16.2 test
+ */
+TEST(example16_sub2)
+{
+    ASSERT(true);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 16 test
+ */
+TEST(example16)
+{
+    TEST_RUN(example16_sub1);
+    TEST_RUN(example16_sub2);
+
+    // Lambda test uses locals of this test
+    std::vector<int> data(1000, 7);
+    tester::run_test([&] {
+        ASSERT(data.size() == 1000 && data[5] == 7);
+    }, "example16_lambda");
+}
+
+/* ************************************************************************ */
+
+void tests_run()
+{
+    TEST_RUN(example16);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Main function.
+ */
+int main(int argc, char** argv)
+{
+    return tester::run_tests(argc, argv, tests_run);
+}
+
+/* ************************************************************************ */
@@ -35,7 +35,8 @@
 /* INCLUDES                                                                 */
 /* ************************************************************************ */
 
-// Tester library
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
 #include "../tester.hpp"
 
 /* ************************************************************************ */
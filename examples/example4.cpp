@@ -34,7 +34,8 @@
 /* INCLUDES                                                                 */
 /* ************************************************************************ */
 
-// Tester library
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
 #include "../tester.hpp"
 
 /* ************************************************************************ */
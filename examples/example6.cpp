@@ -0,0 +1,143 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* Tester library                                                           */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* The MIT License (MIT)                                                    */
+/*                                                                          */
+/* Permission is hereby granted, free of charge, to any person obtaining    */
+/* a copy of this software and associated documentation files (the          */
+/* "Software"), to deal in the Software without restriction, including      */
+/* without limitation the rights to use, copy, modify, merge, publish,      */
+/* distribute, sublicense, and/or sell copies of the Software, and to       */
+/* permit persons to whom the Software is furnished to do so, subject to    */
+/* the following conditions:                                                */
+/*                                                                          */
+/* The above copyright notice and this permission notice shall be included  */
+/* in all copies or substantial portions of the Software.                   */
+/*                                                                          */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  */
+/* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/**
+ * Fuzz test replays corpus files. The same binary can be run by libFuzzer
+ * with --fuzz=example6_parsers/example6 when it's linked with libFuzzer.
+ */
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <string>
+#include <sstream>
+
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
+#include "../tester.hpp"
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Parses unsigned decimal number.
+ *
+ * @param data  Input data.
+ * @param size  Input size.
+ * @param value Parsed value.
+ *
+ * @return If input is a number that fits into value.
+ */
+static bool parse_number(const unsigned char* data, std::size_t size, unsigned long& value)
+{
+    if (!size)
+        return false;
+
+    value = 0;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (data[i] < '0' || data[i] > '9')
+            return false;
+
+        const unsigned long digit = data[i] - '0';
+
+        if (value > (static_cast<unsigned long>(-1) - digit) / 10)
+            return false;
+
+        value = value * 10 + digit;
+    }
+
+    return true;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns corpus directory next to this file.
+ */
+static std::string corpus_dir()
+{
+    const std::string path = __FILE__;
+    return path.substr(0, path.find_last_of("/\\") + 1) + "corpus6";
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 6 fuzz test
+ */
+FUZZ_TEST(example6, data, size)
+{
+    unsigned long value;
+
+    if (!parse_number(data, size, value))
+        return;
+
+    // Parsed number is formatted back without leading zeros
+    std::ostringstream oss;
+    oss << value;
+    const std::string str = oss.str();
+
+    unsigned long parsed;
+    ASSERT(parse_number(reinterpret_cast<const unsigned char*>(str.data()), str.size(), parsed));
+    ASSERT_EQ(parsed, value);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 6 parsers test
+ */
+TEST(example6_parsers)
+{
+    FUZZ_RUN(example6, corpus_dir());
+}
+
+/* ************************************************************************ */
+
+void tests_run()
+{
+    TEST_RUN(example6_parsers);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Main function.
+ */
+int main(int argc, char** argv)
+{
+    return tester::run_tests(argc, argv, tests_run);
+}
+
+/* ************************************************************************ */
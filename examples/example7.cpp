@@ -0,0 +1,95 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* Tester library                                                           */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* The MIT License (MIT)                                                    */
+/*                                                                          */
+/* Permission is hereby granted, free of charge, to any person obtaining    */
+/* a copy of this software and associated documentation files (the          */
+/* "Software"), to deal in the Software without restriction, including      */
+/* without limitation the rights to use, copy, modify, merge, publish,      */
+/* distribute, sublicense, and/or sell copies of the Software, and to       */
+/* permit persons to whom the Software is furnished to do so, subject to    */
+/* the following conditions:                                                */
+/*                                                                          */
+/* The above copyright notice and this permission notice shall be included  */
+/* in all copies or substantial portions of the Software.                   */
+/*                                                                          */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  */
+/* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/**
+ * Stress test runs the same body on multiple threads started together.
+ * Assertions of all threads are counted and their failures are recorded
+ * into the test. Throughput and fairness are printed with the result.
+ */
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
+#include "../tester.hpp"
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Example 7 test
+ */
+TEST(example7)
+{
+    std::mutex mutex;
+    std::vector<unsigned int> values;
+    std::atomic<unsigned int> next(0);
+
+    // Each thread stores unique values from the shared counter
+    const tester::stress_result result = tester::run_stress([&](tester::stress_thread& thread) {
+        for (; thread.ops < 10000; ++thread.ops)
+        {
+            const unsigned int value = next++;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            ASSERT(values.size() < 4 * 10000);
+            values.push_back(value);
+        }
+    }, 4);
+
+    ASSERT_EQ(result.total, 4 * 10000u);
+    ASSERT_EQ(values.size(), 4 * 10000u);
+}
+
+/* ************************************************************************ */
+
+void tests_run()
+{
+    TEST_RUN(example7);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Main function.
+ */
+int main()
+{
+    return tester::run_tests(tests_run);
+}
+
+/* ************************************************************************ */
@@ -0,0 +1,197 @@
+/* ************************************************************************ */
+/*                                                                          */
+/* Tester library                                                           */
+/* Copyright (C) 2013 Jiří Fatka <ntsfka@gmail.com>                         */
+/*                                                                          */
+/* The MIT License (MIT)                                                    */
+/*                                                                          */
+/* Permission is hereby granted, free of charge, to any person obtaining    */
+/* a copy of this software and associated documentation files (the          */
+/* "Software"), to deal in the Software without restriction, including      */
+/* without limitation the rights to use, copy, modify, merge, publish,      */
+/* distribute, sublicense, and/or sell copies of the Software, and to       */
+/* permit persons to whom the Software is furnished to do so, subject to    */
+/* the following conditions:                                                */
+/*                                                                          */
+/* The above copyright notice and this permission notice shall be included  */
+/* in all copies or substantial portions of the Software.                   */
+/*                                                                          */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  */
+/* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   */
+/*                                                                          */
+/* ************************************************************************ */
+
+
+/**
+ * Snapshot assertions compare output with golden files. The table golden
+ * file is checked in, the big snapshot is rewritten by the test itself next
+ * to the binary. Golden files are rewritten with --update-snapshots.
+ *
+ * The SNAPSHOTS8 environment variable selects another directory for both
+ * golden files, so the checked-in one is never rewritten by the test.
+ */
+
+/* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// C++
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sstream>
+#include <vector>
+
+// Tester library, implementation is here in header-only build
+#define TESTER_IMPLEMENTATION
+#include "../tester.hpp"
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/// Directory of the table snapshot.
+static std::string table_dir;
+
+/// Path of the big snapshot, it's different for each binary.
+static std::string big_path;
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Sets snapshot update mode for the scope.
+ *
+ * Previous mode is restored even if an assertion in the scope fails.
+ */
+class update_scope
+{
+
+// Public Ctors & Dtors
+public:
+
+
+    /**
+     * @brief Constructor.
+     *
+     * @param update New mode.
+     */
+    explicit update_scope(bool update)
+        : m_update(tester::update_snapshots)
+    {
+        tester::update_snapshots = update;
+    }
+
+
+    /**
+     * @brief Destructor.
+     */
+    ~update_scope()
+    {
+        tester::update_snapshots = m_update;
+    }
+
+
+// Private Data Members
+private:
+
+    /// Previous mode.
+    bool m_update;
+
+};
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Returns snapshot directory next to this file.
+ */
+static std::string snapshot_dir()
+{
+    const std::string path = __FILE__;
+    return path.substr(0, path.find_last_of("/\\") + 1) + "snapshots8";
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 8.1 test
+ */
+TEST(example8_table)
+{
+    std::ostringstream oss;
+
+    for (int i = 1; i <= 5; ++i)
+    {
+        for (int j = 1; j <= 5; ++j)
+            oss << (j > 1 ? " " : "") << i * j;
+
+        oss << "\n";
+    }
+
+    ASSERT_SNAPSHOT(oss.str(), table_dir + "/table.txt");
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Example 8.2 test
+ */
+TEST(example8_big)
+{
+    // Spans multiple compared chunks
+    std::vector<unsigned char> data(3 * 1024 * 1024 + 17);
+
+    for (std::size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<unsigned char>(i * 31 + i / 4096);
+
+    // Write the golden file as with --update-snapshots and test it
+    std::remove(big_path.c_str());
+
+    {
+        const update_scope update(true);
+        ASSERT_SNAPSHOT_BUFFER(&data[0], data.size(), big_path);
+    }
+
+    ASSERT_SNAPSHOT_BUFFER(&data[0], data.size(), big_path);
+}
+
+/* ************************************************************************ */
+
+void tests_run()
+{
+    TEST_RUN(example8_table);
+    TEST_RUN(example8_big);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Main function.
+ */
+int main(int argc, char** argv)
+{
+    const char* dir = std::getenv("SNAPSHOTS8");
+
+    if (dir)
+    {
+        table_dir = dir;
+        big_path = table_dir + "/big.snapshot";
+    }
+    else
+    {
+        table_dir = snapshot_dir();
+        big_path = std::string(argc > 0 ? argv[0] : "example8") + ".snapshot";
+    }
+
+    return tester::run_tests(argc, argv, tests_run);
+}
+
+/* ************************************************************************ */
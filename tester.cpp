@@ -25,152 +25,4551 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   */
 /*                                                                          */
 /* ************************************************************************ */
+/* INCLUDES                                                                 */
+/* ************************************************************************ */
+
+// Declaration
+#include "tester.hpp"
+
+// C++
+#include <cstdlib>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <typeinfo>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cerrno>
+#include <fstream>
+#include <ctime>
+#include <map>
+#include <set>
+
+#ifdef CXX11
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+// POSIX
+#if defined(__unix__) || defined(__APPLE__)
+#define TESTER_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <sys/ioctl.h>
+#include <dirent.h>
+#endif
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Exceptions thrown by tests are caught whenever the compiler supports them,
+// even if TESTER_NO_EXCEPTIONS is defined by hand.
+#if !((defined(__GNUC__) && !defined(__EXCEPTIONS)) || \
+      (defined(_MSC_VER) && !defined(_CPPUNWIND)))
+#define TESTER_CATCH
+#endif
+
+// SIMD
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TESTER_X86_SIMD
+#include <immintrin.h>
+#endif
+
+// Coverage runtime hooks, they're available only in instrumented binaries.
+// Weak references don't pull the gcov hooks from libgcov archive so gcov
+// builds have to define TESTER_GCOV.
+#if defined(TESTER_POSIX) && defined(__ELF__)
+#define TESTER_COVERAGE
+#ifdef TESTER_GCOV
+#define TESTER_GCOV_HOOK
+#else
+#define TESTER_GCOV_HOOK __attribute__((weak))
+#endif
+extern "C" {
+void __gcov_reset(void) TESTER_GCOV_HOOK;
+void __gcov_dump(void) TESTER_GCOV_HOOK;
+void __llvm_profile_reset_counters(void) __attribute__((weak));
+}
+#endif
+
+// libFuzzer driver, it's available only when linked with libFuzzer.
+#ifdef __GNUC__
+#define TESTER_LIBFUZZER
+extern "C" int LLVMFuzzerRunDriver(int* argc, char*** argv,
+    int (*callback)(const unsigned char* data, std::size_t size)) __attribute__((weak));
+#endif
+
+/* ************************************************************************ */
+
+namespace tester {
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/// Assertion counter of the current thread.
+TESTER_THREAD_LOCAL unsigned int assertion_count;
+
+/* ************************************************************************ */
+
+/// Test counter.
+unsigned int test_count;
+
+/* ************************************************************************ */
+
+/// Failed test counter.
+unsigned int failed_count;
+
+/* ************************************************************************ */
+
+/// Skipped and disabled test counter.
+unsigned int skipped_count;
+
+/* ************************************************************************ */
+
+/// Quarantined test counter.
+unsigned int quarantine_count;
+
+/* ************************************************************************ */
+
+/// Failed quarantined test counter.
+unsigned int quarantine_failed_count;
+
+/* ************************************************************************ */
+
+/// Maximum number of stored expectation failures per test.
+unsigned int expect_limit = 100;
+
+/* ************************************************************************ */
+
+/// Number of differing elements reported by array assertions.
+unsigned int array_report_limit = 10;
+
+/* ************************************************************************ */
+
+/// If snapshot assertions rewrite golden files instead of testing.
+bool update_snapshots;
+
+/* ************************************************************************ */
+
+/// If resource usage of each test is sampled.
+bool sample_resources;
+
+/* ************************************************************************ */
+
+/// Number of tests in resource usage lists.
+unsigned int resource_top = 5;
+
+/* ************************************************************************ */
+
+/// If output of passing tests is dropped.
+bool capture_output;
+
+/* ************************************************************************ */
+
+/// Directory for per-test coverage data. Empty if disabled.
+std::string coverage_dir;
+
+/* ************************************************************************ */
+
+/// If progress of the run is displayed.
+bool progress;
+
+/* ************************************************************************ */
+
+/// File with test durations used for progress estimation.
+std::string progress_file;
+
+/* ************************************************************************ */
+
+/// File with quarantined test paths. Empty if disabled.
+std::string quarantine_file;
+
+/* ************************************************************************ */
+
+/// If sibling tests are run in random order.
+bool shuffle;
+
+/* ************************************************************************ */
+
+/// Seed of the random order.
+unsigned long shuffle_seed;
+
+/* ************************************************************************ */
+
+/// Number of processes replaying fuzz test corpus.
+unsigned int fuzz_jobs;
+
+/* ************************************************************************ */
+
+/// Name of the fuzz test run by libFuzzer.
+std::string fuzz_target;
+
+/* ************************************************************************ */
+
+/// Arguments passed to libFuzzer.
+static std::vector<std::string> fuzz_args;
+
+/* ************************************************************************ */
+
+/// Innermost failure context frame of the current thread.
+TESTER_THREAD_LOCAL const trace_frame* trace_top;
+
+/* ************************************************************************ */
+
+#ifdef CXX11
+/// Serializes failure recording of stress test threads.
+static std::mutex failure_mutex;
+#endif
+
+/* ************************************************************************ */
+
+/// Error list.
+error_list errors;
+
+/* ************************************************************************ */
+
+/// Failures of quarantined tests.
+error_list quarantine_errors;
+
+/* ************************************************************************ */
+
+/// Tests start time.
+time_point start_time;
+
+/* ************************************************************************ */
+
+/// Tests stop time.
+time_point stop_time;
+
+/* ************************************************************************ */
+
+/// Test call depth.
+static unsigned int depth;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Context of the running test.
+ */
+struct test_context
+{
+    /// Test name.
+    const std::string* name;
+
+    /// Number of failures recorded by the test itself.
+    unsigned int failures;
+
+    /// Number of failures that weren't stored.
+    unsigned int overflow;
+
+    /// Resource budget location, NULL if not set.
+    const char* budget;
+
+    /// Resource budget limits: memory, faults, switches.
+    long budget_limits[3];
+
+    /// Resource usage when budget was set.
+    resource_usage budget_start;
+
+    /// Peak RSS of finished child tests.
+    long child_max_rss;
+
+    /// Report of child tests and not captured output.
+    std::string report;
+
+    /// Captured iostream output.
+    std::string output;
+
+    /// Skip reason, NULL if the test wasn't skipped.
+    const char* skipped;
+};
+
+/* ************************************************************************ */
+
+/// Currently running test.
+static test_context* current;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Test waiting for shuffled run.
+ */
+struct pending_test
+{
+    /// Test function.
+    test_func test;
+
+    /// Test name.
+    std::string name;
+};
+
+/* ************************************************************************ */
+
+/// Tests collected for shuffled run, NULL if tests are run immediately.
+static std::vector<pending_test>* pending;
+
+/* ************************************************************************ */
+
+/// 64-bit shuffle generator word, long long is only an extension of C++98.
+#if defined(CXX11)
+typedef std::uint64_t shuffle_word;
+#elif ULONG_MAX > 0xFFFFFFFFUL
+typedef unsigned long shuffle_word;
+#else
+typedef unsigned long long shuffle_word;
+#endif
+
+/* ************************************************************************ */
+
+/// Shuffle random generator state.
+static shuffle_word shuffle_state;
+
+/* ************************************************************************ */
+
+/// Target of std::cout output written by the current thread, NULL if it
+/// isn't running a test.
+static TESTER_THREAD_LOCAL std::string* output_target;
+
+/* ************************************************************************ */
+
+/// Output capture files for each test depth.
+static std::vector<int> capture_files;
+
+/* ************************************************************************ */
+
+/// Size of arena block.
+static const std::size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+/* ************************************************************************ */
+/* SHUFFLE                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Returns next random number (splitmix64).
+ *
+ * Own generator makes the order reproducible on all platforms.
+ *
+ * @return Next random number.
+ */
+static shuffle_word shuffle_next() noexcept
+{
+    // 64-bit constants are composed, C++98 has no long long literals
+    static const shuffle_word gamma = static_cast<shuffle_word>(0x9E3779B9UL) << 32 | 0x7F4A7C15UL;
+    static const shuffle_word mul1 = static_cast<shuffle_word>(0xBF58476DUL) << 32 | 0x1CE4E5B9UL;
+    static const shuffle_word mul2 = static_cast<shuffle_word>(0x94D049BBUL) << 32 | 0x133111EBUL;
+
+    shuffle_word z = (shuffle_state += gamma);
+    z = (z ^ (z >> 30)) * mul1;
+    z = (z ^ (z >> 27)) * mul2;
+    return z ^ (z >> 31);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Checks if test can be run later than it was called.
+ *
+ * Only plain functions can, other callables can refer to locals of the
+ * calling scope.
+ *
+ * @param test Test.
+ *
+ * @return If the test can be deferred.
+ */
+static bool is_deferrable(const test_func& test) noexcept
+{
+#ifdef CXX11
+    return test.target<void (*)()>() != NULL;
+#else
+    (void) test;
+    return true;
+#endif
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Runs collected tests in random order.
+ *
+ * @param tests Collected tests.
+ */
+static void run_pending(std::vector<pending_test>& tests)
+{
+    // Fisher-Yates
+    for (std::size_t i = tests.size(); i > 1; --i)
+        std::swap(tests[i - 1], tests[shuffle_next() % i]);
+
+    for (std::size_t i = 0; i < tests.size(); ++i)
+        run_test(tests[i].test, tests[i].name);
+}
+
+/* ************************************************************************ */
+/* OUTPUT                                                                   */
+/* ************************************************************************ */
+
+/**
+ * @brief Stream buffer that sends output of threads running tests to their
+ * tests.
+ *
+ * Output of other threads goes to the original buffer or to a descriptor
+ * when the standard output descriptor is captured. The buffer has no put
+ * area so it doesn't share any state between threads.
+ */
+class output_buffer : public std::streambuf
+{
+
+// Public Ctors & Dtors
+public:
+
+
+    /**
+     * @brief Constructor.
+     *
+     * @param original Original buffer.
+     */
+    explicit output_buffer(std::streambuf* original)
+        : m_original(original)
+        , m_descriptor(-1)
+    {
+        // Nothing to do
+    }
+
+
+// Public Mutators
+public:
+
+
+    /**
+     * @brief Sets descriptor for output of other threads.
+     *
+     * @param descriptor Descriptor or -1 to use the original buffer.
+     */
+    void set_descriptor(int descriptor) noexcept
+    {
+        m_descriptor = descriptor;
+    }
+
+
+// Protected Operations
+protected:
+
+
+    int overflow(int c)
+    {
+        if (traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+
+        if (output_target)
+        {
+            output_target->push_back(traits_type::to_char_type(c));
+            return c;
+        }
+
+        if (m_descriptor >= 0)
+        {
+            const char ch = traits_type::to_char_type(c);
+            return write_descriptor(&ch, 1) ? c : traits_type::eof();
+        }
+
+        return m_original->sputc(traits_type::to_char_type(c));
+    }
+
+
+    std::streamsize xsputn(const char* s, std::streamsize n)
+    {
+        if (output_target)
+        {
+            output_target->append(s, static_cast<std::size_t>(n));
+            return n;
+        }
+
+        if (m_descriptor >= 0)
+            return write_descriptor(s, n) ? n : 0;
+
+        return m_original->sputn(s, n);
+    }
+
+
+    int sync()
+    {
+        return output_target || m_descriptor >= 0 ? 0 : m_original->pubsync();
+    }
+
+
+// Private Operations
+private:
+
+
+    /**
+     * @brief Writes data into the descriptor.
+     *
+     * @param s Data.
+     * @param n Data size.
+     *
+     * @return If all data were written.
+     */
+    bool write_descriptor(const char* s, std::streamsize n) const noexcept
+    {
+#ifdef TESTER_POSIX
+        while (n > 0)
+        {
+            const ssize_t len = ::write(m_descriptor, s, static_cast<std::size_t>(n));
+
+            if (len < 0 && errno == EINTR)
+                continue;
+
+            if (len <= 0)
+                return false;
+
+            s += len;
+            n -= len;
+        }
+
+        return true;
+#else
+        (void) s;
+        (void) n;
+        return false;
+#endif
+    }
+
+
+// Private Data Members
+private:
+
+    /// Original buffer.
+    std::streambuf* m_original;
+
+    /// Descriptor for output of other threads, -1 if not used.
+    int m_descriptor;
+
+};
+
+/* ************************************************************************ */
+
+/// Buffer of std::cout between start() and stop(). It's never destroyed
+/// because threads started by tests can outlive them.
+static output_buffer* output_redirect;
+
+/* ************************************************************************ */
+
+/// Buffer of std::cout replaced by start(), NULL if not replaced.
+static std::streambuf* output_original;
+
+/* ************************************************************************ */
+
+/// Duplicate of the original standard output descriptor, it's used by
+/// threads that don't run tests while the descriptor is captured.
+static int output_descriptor = -1;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Redirects standard output file descriptor into a capture file.
+ *
+ * Files are reused by tests at the same depth so dropping output costs
+ * only a truncate.
+ *
+ * @param level Test depth.
+ *
+ * @return Duplicate of the original descriptor or -1.
+ */
+static int capture_begin(unsigned int level)
+{
+#ifdef TESTER_POSIX
+    if (capture_files.size() <= level)
+        capture_files.resize(level + 1, -1);
+
+    int& file = capture_files[level];
+
+    if (file < 0)
+    {
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+        file = ::memfd_create("tester", MFD_CLOEXEC);
+#endif
+        if (file < 0)
+        {
+            if (std::FILE* tmp = std::tmpfile())
+            {
+                file = ::dup(::fileno(tmp));
+                std::fclose(tmp);
+            }
+        }
+
+        if (file < 0)
+            return -1;
+    }
+
+    if (::ftruncate(file, 0) != 0 || ::lseek(file, 0, SEEK_SET) != 0)
+        return -1;
+
+    std::fflush(stdout);
+
+    const int saved = ::dup(STDOUT_FILENO);
+    if (saved >= 0)
+        ::dup2(file, STDOUT_FILENO);
+
+    return saved;
+#else
+    (void) level;
+    return -1;
+#endif
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Restores standard output file descriptor.
+ *
+ * @param level Test depth.
+ * @param saved Duplicate of the original descriptor.
+ * @param keep  If captured output should be read.
+ * @param out   Captured output.
+ */
+static void capture_end(unsigned int level, int saved, bool keep, std::string& out)
+{
+#ifdef TESTER_POSIX
+    if (saved < 0)
+        return;
+
+    std::fflush(stdout);
+    ::dup2(saved, STDOUT_FILENO);
+    ::close(saved);
+
+    if (!keep)
+        return;
+
+    const int file = capture_files[level];
+    char buffer[4096];
+    ::lseek(file, 0, SEEK_SET);
+
+    for (ssize_t len; (len = ::read(file, buffer, sizeof(buffer))) > 0; )
+        out.append(buffer, static_cast<std::size_t>(len));
+#else
+    (void) level;
+    (void) saved;
+    (void) keep;
+    (void) out;
+#endif
+}
+
+/* ************************************************************************ */
+/* FAILURES                                                                 */
+/* ************************************************************************ */
+
+/**
+ * @brief Appends failure context of the current thread to failure details.
+ *
+ * Frames are printed from the outermost one, each on its own line.
+ *
+ * @param detail Failure details.
+ *
+ * @return Details followed by the context.
+ */
+static std::string add_trace(const std::string& detail)
+{
+    std::vector<const trace_frame*> frames;
+    for (const trace_frame* frame = trace_top; frame; frame = frame->prev)
+        frames.push_back(frame);
+
+    std::ostringstream oss;
+    oss << detail;
+
+    for (std::size_t i = frames.size(); i--; )
+    {
+        oss << "\n    with ";
+
+        // String literals are printed without label
+        if (frames[i]->label && frames[i]->label[0] != '"')
+            oss << frames[i]->label << " = ";
+
+        frames[i]->print(oss, frames[i]->data);
+    }
+
+    return oss.str();
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Reports assertion failure.
+ *
+ * Throws assert_error or, without exceptions, records the failure into the
+ * current test in the same way run_test would record the exception.
+ *
+ * @param location Static location string. Can be NULL.
+ * @param message  Failure details.
+ *
+ * @throw assert_error
+ */
+static void fail(const char* location, const std::string& message)
+{
+    const std::string detail = trace_top ? add_trace(message) : message;
+
+#ifdef TESTER_NO_EXCEPTIONS
+    static const std::string none;
+    const std::string& name = current ? *current->name : none;
+
+#ifdef CXX11
+    std::lock_guard<std::mutex> lock(failure_mutex);
+#endif
+
+    errors.add(failure_assert, name, location, detail.empty() ? NULL : detail.data(),
+        detail.length());
+
+    if (current)
+        current->failures++;
+#else
+    if (location)
+        throw assert_error(detail, location);
+    else
+        throw assert_error(detail);
+#endif
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Calls test and records its failure.
+ *
+ * Uncaught exceptions are recorded with the failure context that is active
+ * outside of the test.
+ *
+ * @param call    Test call.
+ * @param name    Test name.
+ * @param context Test context.
+ */
+template<typename F>
+static void call_test(const F& call, const std::string& name, test_context& context)
+{
+#ifndef TESTER_CATCH
+    // Failures are recorded directly
+    (void) name;
+    (void) context;
+    call();
+#else
+    try
+    {
+        call();
+    }
+    catch (const skip_error& e)
+    {
+        context.skipped = e.reason();
+    }
+    catch (const assert_error& e)
+    {
+        context.failures++;
+
+        if (e.location())
+        {
+            const char* detail = e.detail();
+            const std::size_t length = std::strlen(detail);
+            errors.add(failure_assert, name, e.location(), length ? detail : NULL, length);
+        }
+        else
+            errors.add(failure_assert, name, NULL, e.what(), std::strlen(e.what()));
+    }
+    catch (const std::exception& e)
+    {
+        context.failures++;
+
+        const std::string message = trace_top ? add_trace(e.what()) : e.what();
+        errors.add(failure_exception, name, typeid(e).name(),
+            message.data(), message.length());
+    }
+    catch (...)
+    {
+        context.failures++;
+
+        if (trace_top)
+        {
+            const std::string message = add_trace(std::string());
+            errors.add(failure_unknown, name, NULL, message.data(), message.length());
+        }
+        else
+            errors.add(failure_unknown, name, NULL);
+    }
+#endif
+}
+
+/* ************************************************************************ */
+/* ARRAY KERNELS                                                            */
+/* ************************************************************************ */
+
+/// Returns position of the first differing byte or n.
+typedef std::size_t (*mismatch_bytes_func)(const unsigned char*, const unsigned char*, std::size_t);
+
+/// Returns position of the first element not within tolerance or n.
+typedef std::size_t (*mismatch_float_func)(const float*, const float*, std::size_t, float);
+
+/// Returns position of the first element not within tolerance or n.
+typedef std::size_t (*mismatch_double_func)(const double*, const double*, std::size_t, double);
+
+/* ************************************************************************ */
+
+static std::size_t mismatch_bytes_scalar(const unsigned char* a, const unsigned char* b, std::size_t n)
+{
+    std::size_t i = 0;
+
+    // Skip equal blocks
+    for (; i + 256 <= n; i += 256)
+        if (std::memcmp(a + i, b + i, 256) != 0)
+            break;
+
+    for (; i < n; ++i)
+        if (a[i] != b[i])
+            return i;
+
+    return n;
+}
+
+/* ************************************************************************ */
+
+template<typename T>
+static std::size_t mismatch_near_scalar(const T* a, const T* b, std::size_t n, T tol)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        if (!(a[i] == b[i] || std::fabs(a[i] - b[i]) <= tol))
+            return i;
+
+    return n;
+}
+
+/* ************************************************************************ */
+
+#ifdef TESTER_X86_SIMD
+
+__attribute__((target("sse2")))
+static std::size_t mismatch_bytes_sse2(const unsigned char* a, const unsigned char* b, std::size_t n)
+{
+    std::size_t i = 0;
+
+    for (; i + 32 <= n; i += 32)
+    {
+        const __m128i eq0 = _mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        const __m128i eq1 = _mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16)));
+
+        if (_mm_movemask_epi8(_mm_and_si128(eq0, eq1)) != 0xFFFF)
+            break;
+    }
+
+    for (; i < n; ++i)
+        if (a[i] != b[i])
+            return i;
+
+    return n;
+}
+
+/* ************************************************************************ */
+
+__attribute__((target("avx2")))
+static std::size_t mismatch_bytes_avx2(const unsigned char* a, const unsigned char* b, std::size_t n)
+{
+    std::size_t i = 0;
+
+    for (; i + 64 <= n; i += 64)
+    {
+        const __m256i eq0 = _mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        const __m256i eq1 = _mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 32)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 32)));
+
+        if (_mm256_movemask_epi8(_mm256_and_si256(eq0, eq1)) != -1)
+            break;
+    }
+
+    for (; i < n; ++i)
+        if (a[i] != b[i])
+            return i;
+
+    return n;
+}
+
+/* ************************************************************************ */
+
+__attribute__((target("sse2")))
+static std::size_t mismatch_float_sse2(const float* a, const float* b, std::size_t n, float tol)
+{
+    const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 vtol = _mm_set1_ps(tol);
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m128 va = _mm_loadu_ps(a + i);
+        const __m128 vb = _mm_loadu_ps(b + i);
+        const __m128 diff = _mm_and_ps(_mm_sub_ps(va, vb), mask);
+        const __m128 ok = _mm_or_ps(_mm_cmpeq_ps(va, vb), _mm_cmple_ps(diff, vtol));
+
+        if (_mm_movemask_ps(ok) != 0xF)
+            break;
+    }
+
+    return i + mismatch_near_scalar(a + i, b + i, n - i, tol);
+}
+
+/* ************************************************************************ */
+
+__attribute__((target("avx2")))
+static std::size_t mismatch_float_avx2(const float* a, const float* b, std::size_t n, float tol)
+{
+    const __m256 mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256 vtol = _mm256_set1_ps(tol);
+    std::size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256 va = _mm256_loadu_ps(a + i);
+        const __m256 vb = _mm256_loadu_ps(b + i);
+        const __m256 diff = _mm256_and_ps(_mm256_sub_ps(va, vb), mask);
+        const __m256 ok = _mm256_or_ps(_mm256_cmp_ps(va, vb, _CMP_EQ_OQ),
+            _mm256_cmp_ps(diff, vtol, _CMP_LE_OQ));
+
+        if (_mm256_movemask_ps(ok) != 0xFF)
+            break;
+    }
+
+    return i + mismatch_near_scalar(a + i, b + i, n - i, tol);
+}
+
+/* ************************************************************************ */
+
+__attribute__((target("sse2")))
+static std::size_t mismatch_double_sse2(const double* a, const double* b, std::size_t n, double tol)
+{
+    const __m128d mask = _mm_castsi128_pd(_mm_srli_epi64(_mm_set1_epi32(-1), 1));
+    const __m128d vtol = _mm_set1_pd(tol);
+    std::size_t i = 0;
+
+    for (; i + 2 <= n; i += 2)
+    {
+        const __m128d va = _mm_loadu_pd(a + i);
+        const __m128d vb = _mm_loadu_pd(b + i);
+        const __m128d diff = _mm_and_pd(_mm_sub_pd(va, vb), mask);
+        const __m128d ok = _mm_or_pd(_mm_cmpeq_pd(va, vb), _mm_cmple_pd(diff, vtol));
+
+        if (_mm_movemask_pd(ok) != 0x3)
+            break;
+    }
+
+    return i + mismatch_near_scalar(a + i, b + i, n - i, tol);
+}
+
+/* ************************************************************************ */
+
+__attribute__((target("avx2")))
+static std::size_t mismatch_double_avx2(const double* a, const double* b, std::size_t n, double tol)
+{
+    const __m256d mask = _mm256_castsi256_pd(_mm256_srli_epi64(_mm256_set1_epi32(-1), 1));
+    const __m256d vtol = _mm256_set1_pd(tol);
+    std::size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256d va = _mm256_loadu_pd(a + i);
+        const __m256d vb = _mm256_loadu_pd(b + i);
+        const __m256d diff = _mm256_and_pd(_mm256_sub_pd(va, vb), mask);
+        const __m256d ok = _mm256_or_pd(_mm256_cmp_pd(va, vb, _CMP_EQ_OQ),
+            _mm256_cmp_pd(diff, vtol, _CMP_LE_OQ));
+
+        if (_mm256_movemask_pd(ok) != 0xF)
+            break;
+    }
+
+    return i + mismatch_near_scalar(a + i, b + i, n - i, tol);
+}
+
+#endif
+
+/* ************************************************************************ */
+
+/**
+ * @brief Selected array kernels.
+ */
+struct array_kernels
+{
+    mismatch_bytes_func bytes;
+    mismatch_float_func floats;
+    mismatch_double_func doubles;
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Selects kernels for the current CPU.
+ *
+ * @return Kernels matching the CPU features.
+ */
+static array_kernels select_array_kernels()
+{
+    array_kernels kernels = {
+        mismatch_bytes_scalar,
+        mismatch_near_scalar<float>,
+        mismatch_near_scalar<double>
+    };
+
+#ifdef TESTER_X86_SIMD
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        kernels.bytes = mismatch_bytes_avx2;
+        kernels.floats = mismatch_float_avx2;
+        kernels.doubles = mismatch_double_avx2;
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        kernels.bytes = mismatch_bytes_sse2;
+        kernels.floats = mismatch_float_sse2;
+        kernels.doubles = mismatch_double_sse2;
+    }
+#endif
+
+    return kernels;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns kernels for the current CPU.
+ *
+ * Initialization of the local static is thread-safe so the kernels can be
+ * used by stress test threads.
+ *
+ * @return Kernels for the current CPU.
+ */
+static const array_kernels& get_array_kernels()
+{
+    static const array_kernels kernels = select_array_kernels();
+
+    return kernels;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints array element.
+ *
+ * Character types are printed as numbers.
+ */
+template<typename T>
+static void print_value(std::ostream& os, T value)
+{
+    os << value;
+}
+
+static void print_value(std::ostream& os, char value)
+{
+    os << static_cast<int>(value);
+}
+
+static void print_value(std::ostream& os, signed char value)
+{
+    os << static_cast<int>(value);
+}
+
+static void print_value(std::ostream& os, unsigned char value)
+{
+    os << static_cast<int>(value);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Reports differing arrays.
+ *
+ * @param lhs    Left array.
+ * @param rhs    Right array.
+ * @param first  Position of the first differing element.
+ * @param n      Number of elements.
+ * @param tol    Tolerance.
+ * @param errstr Location string.
+ *
+ * @return false.
+ *
+ * @throw assert_error
+ */
+template<typename T>
+static bool array_failed(const T* lhs, const T* rhs, std::size_t first,
+    std::size_t n, double tol, const char* errstr)
+{
+    std::ostringstream elements;
+    std::size_t count = 0;
+    double max_abs = 0;
+    double max_rel = 0;
+
+    for (std::size_t i = first; i < n; ++i)
+    {
+        const double a = static_cast<double>(lhs[i]);
+        const double b = static_cast<double>(rhs[i]);
+
+        // The first element is known to differ
+        if (i != first && (lhs[i] == rhs[i] || (tol > 0 && std::fabs(a - b) <= tol)))
+            continue;
+
+        const double abs = std::fabs(a - b);
+        const double rel = abs / std::max(std::fabs(a), std::fabs(b));
+
+        // NaN comparison is always false
+        if (!(abs <= max_abs))
+            max_abs = abs;
+
+        if (!(rel <= max_rel))
+            max_rel = rel;
+
+        if (count < array_report_limit)
+        {
+            elements << (count ? ", [" : "[") << i << "] ";
+            print_value(elements, lhs[i]);
+            elements << " != ";
+            print_value(elements, rhs[i]);
+        }
+
+        count++;
+    }
+
+    if (count > array_report_limit)
+        elements << ", ...";
+
+    std::ostringstream oss;
+    oss << count << " of " << n << " elements differ, max abs error " << max_abs
+        << ", max rel error " << max_rel << ": " << elements.str();
+
+    fail(errstr, oss.str());
+
+    return false;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Tests integer arrays equality.
+ */
+template<typename T>
+static bool array_eq(const T* lhs, const T* rhs, std::size_t n, const char* errstr)
+{
+    const std::size_t pos = get_array_kernels().bytes(
+        reinterpret_cast<const unsigned char*>(lhs),
+        reinterpret_cast<const unsigned char*>(rhs), n * sizeof(T)) / sizeof(T);
+
+    if (pos != n)
+        return array_failed(lhs, rhs, pos, n, 0, errstr);
+
+    assertion_count++;
+    return true;
+}
+
+/* ************************************************************************ */
+/* SNAPSHOTS                                                                */
+/* ************************************************************************ */
+
+/// Size of chunk compared at once.
+static const std::size_t SNAPSHOT_CHUNK_SIZE = 1024 * 1024;
+
+/// Number of context characters printed around difference.
+static const std::size_t SNAPSHOT_CONTEXT = 40;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Read-only view of the whole file.
+ *
+ * File is memory mapped on POSIX systems and read into memory elsewhere.
+ */
+class mapped_file
+{
+
+// Public Ctors & Dtors
+public:
+
+
+    /**
+     * @brief Opens file.
+     *
+     * @param path File path.
+     */
+    explicit mapped_file(const std::string& path)
+        : m_data(NULL)
+        , m_size(0)
+        , m_open(false)
+    {
+#ifdef TESTER_POSIX
+        const int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd < 0)
+            return;
+
+        struct stat st;
+        if (::fstat(fd, &st) == 0)
+        {
+            m_size = static_cast<std::size_t>(st.st_size);
+            m_open = true;
+
+            if (m_size)
+            {
+                void* ptr = ::mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                if (ptr != MAP_FAILED)
+                {
+                    ::madvise(ptr, m_size, MADV_SEQUENTIAL);
+                    m_data = static_cast<const unsigned char*>(ptr);
+                }
+                else
+                {
+                    m_open = false;
+                }
+            }
+        }
+
+        ::close(fd);
+#else
+        std::ifstream file(path.c_str(), std::ios::binary);
+
+        if (!file)
+            return;
+
+        m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_size = m_buffer.size();
+        m_data = reinterpret_cast<const unsigned char*>(m_buffer.data());
+        m_open = true;
+#endif
+
+    }
+
+
+    /**
+     * @brief Destructor.
+     */
+    ~mapped_file()
+    {
+#ifdef TESTER_POSIX
+        if (m_data)
+            ::munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+
+    }
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Returns if file is opened.
+     */
+    bool is_open() const noexcept
+    {
+        return m_open;
+    }
+
+
+    /**
+     * @brief Returns file data.
+     */
+    const unsigned char* data() const noexcept
+    {
+        return m_data;
+    }
+
+
+    /**
+     * @brief Returns file size.
+     */
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+
+// Private Ctors
+private:
+
+
+    /// Non-copyable.
+    mapped_file(const mapped_file&);
+
+
+    /// Non-assignable.
+    mapped_file& operator=(const mapped_file&);
+
+
+// Private Data Members
+private:
+
+    /// File data.
+    const unsigned char* m_data;
+
+    /// File size.
+    std::size_t m_size;
+
+    /// If file is opened.
+    bool m_open;
+
+#ifndef TESTER_POSIX
+    /// File content.
+    std::string m_buffer;
+#endif
+
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Writes file atomically.
+ *
+ * Data are written into a temporary file which is renamed to the target.
+ *
+ * @param path File path.
+ * @param data Data.
+ * @param size Data size.
+ *
+ * @return If file was written.
+ */
+static bool write_file(const std::string& path, const void* data, std::size_t size)
+{
+    const std::string tmp = path + ".tmp";
+
+    {
+        std::ofstream file(tmp.c_str(), std::ios::binary | std::ios::trunc);
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        file.close();
+
+        if (!file)
+        {
+            std::remove(tmp.c_str());
+            return false;
+        }
+    }
+
+#ifndef TESTER_POSIX
+    // Rename doesn't replace existing file
+    std::remove(path.c_str());
+#endif
+
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmp.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints line context around the position.
+ *
+ * @param os   Output stream.
+ * @param data Data.
+ * @param size Data size.
+ * @param pos  Position.
+ */
+static void print_context(std::ostream& os, const unsigned char* data,
+    std::size_t size, std::size_t pos)
+{
+    // Find line start
+    std::size_t first = pos;
+    while (first > 0 && data[first - 1] != '\n' && pos - first < SNAPSHOT_CONTEXT)
+        first--;
+
+    os << "\"";
+
+    if (first > 0 && data[first - 1] != '\n')
+        os << "...";
+
+    std::size_t i = first;
+    for (; i < size && data[i] != '\n' && i < pos + SNAPSHOT_CONTEXT; ++i)
+    {
+        const unsigned char c = data[i];
+
+        if (c == '\\' || c == '"')
+            os << '\\' << c;
+        else if (c == '\t')
+            os << "\\t";
+        else if (c == '\r')
+            os << "\\r";
+        else if (c < 0x20 || c >= 0x7F)
+            os << "\\x" << std::hex << std::setw(2) << std::setfill('0')
+               << static_cast<int>(c) << std::dec << std::setfill(' ');
+        else
+            os << c;
+    }
+
+    if (i < size && data[i] != '\n')
+        os << "...";
+
+    os << "\"";
+}
+
+/* ************************************************************************ */
+/* COVERAGE                                                                 */
+/* ************************************************************************ */
+
+/// If coverage runtime is available and coverage is enabled.
+static bool coverage_enabled;
+
+/// Map of test indices to test paths.
+static std::ofstream coverage_map;
+
+/// Covered function IDs of each test.
+static std::ofstream coverage_records;
+
+/// Map of function IDs to functions.
+static std::ofstream coverage_functions;
+
+/// Last assigned test index, 0 is used for code outside tests.
+static unsigned int coverage_last;
+
+/// Indices of running tests.
+static std::vector<unsigned int> coverage_indices;
+
+/// Covered function IDs of running tests.
+static std::vector<std::set<unsigned long> > coverage_covered;
+
+/// Function IDs by data file and function ident.
+static std::map<std::string, unsigned long> coverage_ids;
+
+/// Function locations by data file.
+static std::map<std::string, std::map<unsigned int, std::string> > coverage_notes;
+
+/// Path of the running test.
+static std::string coverage_path;
+
+/// Original gcov environment variables.
+static std::string coverage_env[2];
+
+/// If original gcov environment variables were set.
+static bool coverage_env_set[2];
+
+/// Names of gcov environment variables.
+static const char* const COVERAGE_ENV_NAMES[2] = { "GCOV_PREFIX", "GCOV_PREFIX_STRIP" };
+
+/* ************************************************************************ */
+
+#ifdef TESTER_COVERAGE
+
+/**
+ * @brief gcov data and notes file reader.
+ *
+ * Formats of GCC 8 and newer are supported, GCC 12 changed lengths from
+ * words to bytes and stopped padding strings.
+ */
+class gcov_reader
+{
+
+// Public Ctors
+public:
+
+
+    /**
+     * @brief Reads the whole file.
+     *
+     * @param path File path.
+     */
+    explicit gcov_reader(const std::string& path)
+        : m_pos(0)
+        , m_major(0)
+    {
+        std::ifstream file(path.c_str(), std::ios::binary);
+        m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Reads file header.
+     *
+     * @param magic Expected magic number.
+     *
+     * @return If the file has expected magic number.
+     */
+    bool header(unsigned int magic)
+    {
+        if (word() != magic)
+            return false;
+
+        // Version is encoded as "A93*" for GCC 9.3 or "B22*" for GCC 12.2
+        const unsigned int version = word();
+        const int first = static_cast<int>(version >> 24);
+        const int second = static_cast<int>((version >> 16) & 0xff);
+        m_major = first >= 'A' ? (first - 'A') * 10 + second - '0' : first - '0';
+
+        // Stamp and checksum
+        word();
+
+        if (m_major >= 12)
+            word();
+
+        return !failed();
+    }
+
+
+    /**
+     * @brief Reads record header.
+     *
+     * @param tag    Record tag.
+     * @param length Record length in bytes.
+     *
+     * @return If record was read.
+     */
+    bool record(unsigned int& tag, std::size_t& length)
+    {
+        tag = word();
+        const unsigned int len = word();
+
+        if (failed())
+            return false;
+
+        // Negative length marks zero counters without data
+        if (m_major >= 12)
+            length = static_cast<int>(len) < 0 ? 0 : len;
+        else
+            length = len * 4;
+
+        return true;
+    }
+
+
+    /**
+     * @brief Reads 32-bit word.
+     *
+     * @return Word or 0 past the end of file.
+     */
+    unsigned int word()
+    {
+        if (m_pos + 4 > m_data.size())
+        {
+            m_pos = m_data.size() + 1;
+            return 0;
+        }
+
+        unsigned int value;
+        std::memcpy(&value, &m_data[m_pos], 4);
+        m_pos += 4;
+
+        return value;
+    }
+
+
+    /**
+     * @brief Reads string.
+     *
+     * @return String or empty string past the end of file.
+     */
+    std::string string()
+    {
+        const std::size_t length = m_major >= 12 ? word() : word() * 4;
+
+        if (failed() || m_pos + length > m_data.size())
+        {
+            m_pos = m_data.size() + 1;
+            return std::string();
+        }
+
+        const std::string str(&m_data[m_pos], ::strnlen(&m_data[m_pos], length));
+        m_pos += length;
+
+        return str;
+    }
+
+
+    /**
+     * @brief Tests if any byte in range is nonzero.
+     *
+     * @param length Range length.
+     *
+     * @return If the range contains a nonzero byte.
+     */
+    bool nonzero(std::size_t length) const noexcept
+    {
+        const std::size_t end = std::min(m_pos + length, m_data.size());
+
+        for (std::size_t i = m_pos; i < end; ++i)
+            if (m_data[i])
+                return true;
+
+        return false;
+    }
+
+
+    /**
+     * @brief Moves to position.
+     *
+     * @param pos Position.
+     */
+    void seek(std::size_t pos) noexcept
+    {
+        m_pos = pos;
+    }
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Returns current position.
+     *
+     * @return Current position.
+     */
+    std::size_t position() const noexcept
+    {
+        return m_pos;
+    }
+
+
+    /**
+     * @brief Returns GCC major version of the file.
+     *
+     * @return GCC major version of the file.
+     */
+    int major() const noexcept
+    {
+        return m_major;
+    }
+
+
+    /**
+     * @brief Returns if read went past the end of file.
+     *
+     * @return If read went past the end of file.
+     */
+    bool failed() const noexcept
+    {
+        return m_pos > m_data.size();
+    }
+
+
+// Private Data Members
+private:
+
+    /// File content.
+    std::vector<char> m_data;
+
+    /// Read position.
+    std::size_t m_pos;
+
+    /// GCC major version.
+    int m_major;
+
+};
+
+/* ************************************************************************ */
+
+/// gcov file magic numbers.
+static const unsigned int GCOV_DATA_MAGIC = 0x67636461;
+static const unsigned int GCOV_NOTE_MAGIC = 0x67636e6f;
+
+/// gcov record tags.
+static const unsigned int GCOV_TAG_FUNCTION = 0x01000000;
+static const unsigned int GCOV_TAG_ARCS = 0x01a10000;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Reads function locations from gcov notes file.
+ *
+ * @param path      Notes file path.
+ * @param locations Map of function idents to `<source>:<line>\t<name>`.
+ */
+static void gcov_read_notes(const std::string& path, std::map<unsigned int, std::string>& locations)
+{
+    gcov_reader reader(path);
+
+    if (!reader.header(GCOV_NOTE_MAGIC))
+        return;
+
+    // Working directory and unexecuted blocks flag
+    const std::string cwd = reader.string();
+    reader.word();
+
+    unsigned int tag;
+    std::size_t length;
+
+    while (reader.record(tag, length))
+    {
+        const std::size_t next = reader.position() + length;
+
+        if (tag == GCOV_TAG_FUNCTION)
+        {
+            const unsigned int ident = reader.word();
+            reader.word();
+            reader.word();
+            const std::string name = reader.string();
+            reader.word();
+            const std::string source = reader.string();
+            const unsigned int line = reader.word();
+
+            if (reader.failed())
+                return;
+
+            std::ostringstream oss;
+
+            if (!source.empty() && source[0] != '/' && !cwd.empty())
+                oss << cwd << "/";
+
+            oss << source << ":" << line << "\t" << name;
+            locations[ident] = oss.str();
+        }
+
+        reader.seek(next);
+    }
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns ID of the function, new functions are written into the
+ * function map.
+ *
+ * @param data  Data file path without coverage prefix.
+ * @param ident Function ident.
+ *
+ * @return ID of the function.
+ */
+static unsigned long coverage_function(const std::string& data, unsigned int ident)
+{
+    std::ostringstream key;
+    key << data << "#" << ident;
+
+    const std::map<std::string, unsigned long>::const_iterator it = coverage_ids.find(key.str());
+
+    if (it != coverage_ids.end())
+        return it->second;
+
+    const unsigned long id = static_cast<unsigned long>(coverage_ids.size());
+    coverage_ids[key.str()] = id;
+
+    // Function location is in the notes file next to the data file, it's
+    // read only once
+    std::map<unsigned int, std::string>& locations = coverage_notes[data];
+
+    if (locations.empty())
+        gcov_read_notes(data.substr(0, data.length() - 5) + ".gcno", locations);
+
+    const std::map<unsigned int, std::string>::const_iterator loc = locations.find(ident);
+    coverage_functions << id << "\t";
+
+    if (loc != locations.end())
+        coverage_functions << loc->second << "\n";
+    else
+        coverage_functions << key.str() << "\t?\n";
+
+    return id;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Collects executed functions from gcov data file.
+ *
+ * @param path    Data file path.
+ * @param data    Data file path without coverage prefix.
+ * @param covered Covered function IDs.
+ */
+static void gcov_read_data(const std::string& path, const std::string& data,
+    std::set<unsigned long>& covered)
+{
+    gcov_reader reader(path);
+
+    if (!reader.header(GCOV_DATA_MAGIC))
+        return;
+
+    unsigned int tag;
+    std::size_t length;
+    unsigned int ident = 0;
+    bool function = false;
+
+    while (reader.record(tag, length))
+    {
+        const std::size_t next = reader.position() + length;
+
+        if (tag == GCOV_TAG_FUNCTION)
+        {
+            function = length != 0;
+            ident = function ? reader.word() : 0;
+        }
+        else if (tag == GCOV_TAG_ARCS && function && reader.nonzero(length))
+            covered.insert(coverage_function(data, ident));
+
+        reader.seek(next);
+    }
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Collects executed functions from dumped gcov data and removes it.
+ *
+ * @param dir     Directory.
+ * @param prefix  Coverage prefix length.
+ * @param covered Covered function IDs.
+ */
+static void gcov_collect(const std::string& dir, std::size_t prefix,
+    std::set<unsigned long>& covered)
+{
+    DIR* handle = ::opendir(dir.c_str());
+
+    if (!handle)
+        return;
+
+    while (const dirent* entry = ::readdir(handle))
+    {
+        const std::string name = entry->d_name;
+
+        if (name == "." || name == "..")
+            continue;
+
+        const std::string path = dir + "/" + name;
+        struct stat info;
+
+        if (::lstat(path.c_str(), &info) != 0)
+            continue;
+
+        if (S_ISDIR(info.st_mode))
+        {
+            gcov_collect(path, prefix, covered);
+            ::rmdir(path.c_str());
+        }
+        else if (name.length() > 5 && name.compare(name.length() - 5, 5, ".gcda") == 0)
+        {
+            gcov_read_data(path, path.substr(prefix), covered);
+            std::remove(path.c_str());
+        }
+    }
+
+    ::closedir(handle);
+}
+
+#endif
+
+/* ************************************************************************ */
+
+/**
+ * @brief Collects coverage counters since last dump and resets them.
+ *
+ * gcov data are dumped into `<coverage_dir>/segment/` and executed
+ * functions are read back. Counters are reset after reading so the
+ * reading itself isn't counted into the next test.
+ *
+ * @param covered Covered function IDs.
+ */
+static void coverage_dump(std::set<unsigned long>& covered)
+{
+#ifdef TESTER_COVERAGE
+    // GCOV_PREFIX is read on every dump
+    const std::string segment = coverage_dir + "/segment";
+    ::setenv("GCOV_PREFIX", segment.c_str(), 1);
+    __gcov_dump();
+    gcov_collect(segment, segment.length(), covered);
+    __gcov_reset();
+#else
+    (void) covered;
+#endif
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Writes covered function IDs of the test.
+ *
+ * @param index   Test index.
+ * @param covered Covered function IDs.
+ */
+static void coverage_write(unsigned int index, const std::set<unsigned long>& covered)
+{
+    coverage_records << index;
+
+    for (std::set<unsigned long>::const_iterator it = covered.begin(); it != covered.end(); ++it)
+        coverage_records << (it == covered.begin() ? "\t" : " ") << *it;
+
+    coverage_records << "\n";
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Starts collecting coverage.
+ */
+static void coverage_start()
+{
+    coverage_enabled = false;
+
+    if (coverage_dir.empty())
+        return;
+
+#ifdef TESTER_COVERAGE
+    if (!__gcov_dump)
+    {
+        if (__llvm_profile_reset_counters)
+            std::cerr << "Coverage with LLVM profiles is not supported, build with gcov\n";
+        else
+            std::cerr << "Coverage runtime is not available, build with --coverage "
+                "and TESTER_GCOV\n";
+
+        return;
+    }
+
+    ::mkdir(coverage_dir.c_str(), 0777);
+    coverage_map.open((coverage_dir + "/tests.txt").c_str(), std::ios::trunc);
+    coverage_records.open((coverage_dir + "/coverage.txt").c_str(), std::ios::trunc);
+    coverage_functions.open((coverage_dir + "/functions.txt").c_str(), std::ios::trunc);
+
+    if (!coverage_map || !coverage_records || !coverage_functions)
+    {
+        std::cerr << "Unable to write coverage map into '" << coverage_dir << "'\n";
+        coverage_map.close();
+        coverage_records.close();
+        coverage_functions.close();
+        return;
+    }
+
+    // Dumped paths must be complete to find notes files
+    for (int i = 0; i < 2; ++i)
+    {
+        const char* value = std::getenv(COVERAGE_ENV_NAMES[i]);
+        coverage_env_set[i] = value != NULL;
+        coverage_env[i] = value ? value : "";
+    }
+
+    ::setenv("GCOV_PREFIX_STRIP", "0", 1);
+
+    coverage_enabled = true;
+    coverage_last = 0;
+    coverage_indices.assign(1, 0);
+    coverage_covered.assign(1, std::set<unsigned long>());
+    coverage_ids.clear();
+    coverage_notes.clear();
+    coverage_path.clear();
+
+    // Counters collected before tests
+    coverage_dump(coverage_covered.back());
+#else
+    std::cerr << "Coverage mode is not supported on this platform\n";
+#endif
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Stops collecting coverage.
+ */
+static void coverage_stop()
+{
+    if (!coverage_enabled)
+        return;
+
+    coverage_dump(coverage_covered.back());
+    coverage_write(0, coverage_covered.back());
+
+    coverage_map.close();
+    coverage_records.close();
+    coverage_functions.close();
+    coverage_enabled = false;
+
+#ifdef TESTER_COVERAGE
+    ::rmdir((coverage_dir + "/segment").c_str());
+
+    // Data dumped at exit are written as without tests
+    for (int i = 0; i < 2; ++i)
+    {
+        if (coverage_env_set[i])
+            ::setenv(COVERAGE_ENV_NAMES[i], coverage_env[i].c_str(), 1);
+        else
+            ::unsetenv(COVERAGE_ENV_NAMES[i]);
+    }
+#endif
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Starts test coverage segment.
+ *
+ * Counters collected so far belong to the parent test. Test index and path
+ * are written into the coverage map.
+ *
+ * @param name Test name.
+ */
+static void coverage_enter(const std::string& name)
+{
+    coverage_dump(coverage_covered.back());
+    coverage_indices.push_back(++coverage_last);
+    coverage_covered.push_back(std::set<unsigned long>());
+
+    if (!coverage_path.empty())
+        coverage_path += "/";
+
+    coverage_path += name;
+    coverage_map << coverage_last << "\t" << coverage_path << "\n";
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Finishes test coverage segment.
+ *
+ * Covered functions of the test are written.
+ */
+static void coverage_leave()
+{
+    coverage_dump(coverage_covered.back());
+    coverage_write(coverage_indices.back(), coverage_covered.back());
+    coverage_indices.pop_back();
+    coverage_covered.pop_back();
+
+    const std::string::size_type pos = coverage_path.rfind('/');
+    coverage_path.erase(pos == std::string::npos ? 0 : pos);
+}
+
+/* ************************************************************************ */
+/* RESOURCES                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Sampled resource kinds.
+ */
+enum resource_kind
+{
+    resource_memory,
+    resource_minor_faults,
+    resource_major_faults,
+    resource_voluntary_switches,
+    resource_involuntary_switches,
+    resource_count
+};
+
+/* ************************************************************************ */
+
+/// Resource kind names.
+static const char* const RESOURCE_NAMES[resource_count] = {
+    "Memory growth (kB)",
+    "Minor page faults",
+    "Major page faults",
+    "Voluntary context switches",
+    "Involuntary context switches"
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Resource usage list entry.
+ */
+struct resource_entry
+{
+    /// Usage.
+    long value;
+
+    /// Test name.
+    std::string name;
+};
+
+/* ************************************************************************ */
+
+/// Tests with the highest usage sorted in descending order.
+static std::vector<resource_entry> resource_lists[resource_count];
+
+/* ************************************************************************ */
+
+/**
+ * @brief Resets peak RSS of the process to the current RSS.
+ *
+ * Only Linux supports that, elsewhere peak RSS grows only when the process
+ * peak is exceeded.
+ */
+static void reset_max_rss() noexcept
+{
+#ifdef __linux__
+    if (std::FILE* file = std::fopen("/proc/self/clear_refs", "w"))
+    {
+        std::fputs("5", file);
+        std::fclose(file);
+    }
+#endif
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns resource usage at the end of the test.
+ *
+ * Peak RSS of child tests is included because they reset it.
+ *
+ * @param context Test context.
+ *
+ * @return Resource usage at the end of the test.
+ */
+static resource_usage get_test_usage(const test_context& context)
+{
+    resource_usage usage = get_resource_usage();
+    usage.max_rss = std::max(usage.max_rss, context.child_max_rss);
+
+    return usage;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns memory growth between two samples.
+ *
+ * It's the higher of peak and current RSS growth. Peak RSS is reset before
+ * the first sample where supported.
+ *
+ * @param from First sample.
+ * @param to   Second sample.
+ *
+ * @return Growth in kB.
+ */
+static long memory_growth(const resource_usage& from, const resource_usage& to) noexcept
+{
+    return std::max(to.max_rss - from.max_rss, to.rss - from.rss);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Adds test into the list if it's usage is high enough.
+ *
+ * @param kind  Resource kind.
+ * @param value Usage.
+ * @param name  Test name.
+ */
+static void resource_add(resource_kind kind, long value, const std::string& name)
+{
+    std::vector<resource_entry>& list = resource_lists[kind];
+
+    if (value <= 0 || resource_top == 0)
+        return;
+
+    if (list.size() == resource_top && list.back().value >= value)
+        return;
+
+    std::size_t pos = list.size();
+    while (pos > 0 && list[pos - 1].value < value)
+        pos--;
+
+    resource_entry entry;
+    entry.value = value;
+    entry.name = name;
+    list.insert(list.begin() + pos, entry);
+
+    if (list.size() > resource_top)
+        list.pop_back();
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Adds resource usage of the test into lists.
+ *
+ * @param from Sample before test.
+ * @param to   Sample after test.
+ * @param name Test name.
+ */
+static void resource_sample(const resource_usage& from, const resource_usage& to,
+    const std::string& name)
+{
+    resource_add(resource_memory, memory_growth(from, to), name);
+    resource_add(resource_minor_faults, to.minor_faults - from.minor_faults, name);
+    resource_add(resource_major_faults, to.major_faults - from.major_faults, name);
+    resource_add(resource_voluntary_switches,
+        to.voluntary_switches - from.voluntary_switches, name);
+    resource_add(resource_involuntary_switches,
+        to.involuntary_switches - from.involuntary_switches, name);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Checks resource budget of the finished test.
+ *
+ * @param context Test context.
+ */
+static void resource_check(test_context& context, const resource_usage& usage)
+{
+    const resource_usage& start = context.budget_start;
+    const long values[3] = {
+        memory_growth(start, usage),
+        (usage.minor_faults - start.minor_faults) + (usage.major_faults - start.major_faults),
+        (usage.voluntary_switches - start.voluntary_switches) +
+            (usage.involuntary_switches - start.involuntary_switches)
+    };
+    static const char* const names[3] = { "memory", "faults", "switches" };
+    static const char* const units[3] = { " kB", "", "" };
+
+    std::ostringstream oss;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        if (context.budget_limits[i] < 0 || values[i] <= context.budget_limits[i])
+            continue;
+
+        if (oss.tellp() > 0)
+            oss << ", ";
+
+        oss << names[i] << " " << values[i] << units[i] << " > "
+            << context.budget_limits[i] << units[i];
+    }
+
+    const std::string detail = oss.str();
+
+    if (detail.empty())
+    {
+        assertion_count++;
+        return;
+    }
+
+    errors.add(failure_assert, *context.name, context.budget, detail.data(), detail.length());
+    context.failures++;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints tests with the highest resource usage.
+ */
+static void resource_print()
+{
+    for (int kind = 0; kind < resource_count; ++kind)
+    {
+        const std::vector<resource_entry>& list = resource_lists[kind];
+
+        if (list.empty())
+            continue;
+
+        std::cout << RESOURCE_NAMES[kind] << ":\n";
+
+        for (std::size_t i = 0; i < list.size(); ++i)
+            std::cout << "  " << std::setw(10) << list[i].value << "  " << list[i].name << "\n";
+
+        std::cout << "\n";
+    }
+}
+
+/* ************************************************************************ */
+/* FUZZING                                                                  */
+/* ************************************************************************ */
+
+/// Size of buffer for reading small inputs.
+static const std::size_t FUZZ_READ_SIZE = 64 * 1024;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Fuzz test waiting for run.
+ */
+struct fuzz_test
+{
+    /// Test function.
+    fuzz_func test;
+
+    /// Corpus directory.
+    std::string corpus;
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Call of fuzz test with one input.
+ */
+struct fuzz_call
+{
+    /// Test function.
+    fuzz_func test;
+
+    /// Input data.
+    const unsigned char* data;
+
+    /// Input size.
+    std::size_t size;
+
+    /**
+     * @brief Calls the test.
+     */
+    void operator()() const
+    {
+        test(data, size);
+    }
+};
+
+/* ************************************************************************ */
+
+/// Fuzz test of the running fuzz body.
+static const fuzz_test* fuzz_running;
+
+/* ************************************************************************ */
+
+/// Fuzz test run by libFuzzer.
+static fuzz_func fuzz_selected;
+
+/* ************************************************************************ */
+
+/// Context of the fuzz test run by libFuzzer.
+static test_context* fuzz_context;
+
+/* ************************************************************************ */
+
+/// Path of the test body called to reach the fuzz test run by libFuzzer.
+static std::string fuzz_path;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Runs the current fuzz test with one input.
+ *
+ * @param test Fuzz test.
+ * @param data Input data.
+ * @param size Input size.
+ * @param path Input path, it's added to the failure context.
+ */
+static void fuzz_input(fuzz_func test, const unsigned char* data, std::size_t size,
+    const std::string& path)
+{
+    static const unsigned char empty = 0;
+
+    const scoped_trace trace(&path, &print_trace<std::string>, "input");
+    const fuzz_call call = { test, data ? data : &empty, size };
+    call_test(call, *current->name, *current);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Runs the current fuzz test with input file.
+ *
+ * @param test Fuzz test.
+ * @param path Input path.
+ */
+static void fuzz_file(fuzz_func test, const std::string& path)
+{
+#ifdef TESTER_POSIX
+    // Small inputs are read into a reused buffer, it's cheaper than mapping
+    static std::vector<unsigned char> buffer(FUZZ_READ_SIZE);
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        const ssize_t len = ::read(fd, &buffer[0], buffer.size());
+        ::close(fd);
+
+        if (len >= 0 && static_cast<std::size_t>(len) < buffer.size())
+        {
+            // Exactly sized copy lets sanitizers detect reads after the input
+            const std::vector<unsigned char> data(buffer.begin(), buffer.begin() + len);
+            fuzz_input(test, data.empty() ? NULL : &data[0], data.size(), path);
+            return;
+        }
+    }
+#endif
+
+    const mapped_file file(path);
+
+    if (file.is_open())
+    {
+        fuzz_input(test, file.data(), file.size(), path);
+        return;
+    }
+
+    const std::string message = "cannot read input " + path;
+    errors.add(failure_assert, *current->name, NULL, message.data(), message.length());
+    current->failures++;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Lists corpus files.
+ *
+ * Hidden files and subdirectories are ignored. Directories can be listed
+ * only on POSIX systems, elsewhere the corpus must be a single file.
+ *
+ * @param corpus Corpus directory or file.
+ * @param files  Sorted file paths.
+ *
+ * @return If corpus exists.
+ */
+static bool list_corpus(const std::string& corpus, std::vector<std::string>& files)
+{
+#ifdef TESTER_POSIX
+    struct stat st;
+    if (::stat(corpus.c_str(), &st) != 0)
+        return false;
+
+    if (!S_ISDIR(st.st_mode))
+    {
+        files.push_back(corpus);
+        return true;
+    }
+
+    DIR* dir = ::opendir(corpus.c_str());
+    if (!dir)
+        return false;
+
+    while (const struct dirent* entry = ::readdir(dir))
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+#ifdef DT_DIR
+        if (entry->d_type == DT_DIR)
+            continue;
+#endif
+        files.push_back(corpus + "/" + entry->d_name);
+    }
+
+    ::closedir(dir);
+    std::sort(files.begin(), files.end());
+#else
+    files.push_back(corpus);
+#endif
+
+    return true;
+}
+
+/* ************************************************************************ */
+
+#if defined(TESTER_POSIX) && defined(__GNUC__)
+#define TESTER_FUZZ_FORK
+
+/**
+ * @brief State of corpus replay process shared with the test process.
+ */
+struct fuzz_worker
+{
+    /// Index of the replayed input, number of inputs when finished.
+    volatile std::size_t input;
+
+    /// Number of passed assertions.
+    volatile unsigned int assertions;
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Failure record header written by replay process.
+ *
+ * Location strings have static storage duration so their addresses are
+ * valid in the forked test process too.
+ */
+struct fuzz_record
+{
+    /// Input index.
+    std::size_t input;
+
+    /// Failure kind.
+    failure_kind kind;
+
+    /// Location string. Can be NULL.
+    const char* location;
+
+    /// Message length, message follows the header.
+    std::size_t length;
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Failure of replayed input.
+ */
+struct fuzz_failure
+{
+    /// Failure record, message points to `message`.
+    fuzz_record record;
+
+    /// Failure message.
+    std::string message;
+
+    /**
+     * @brief Orders failures by input.
+     */
+    bool operator<(const fuzz_failure& other) const noexcept
+    {
+        return record.input < other.record.input;
+    }
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Replays inputs in forked process.
+ *
+ * Inputs are taken from the shared counter and failures are written into
+ * the output file immediately so they aren't lost when a later input
+ * crashes.
+ *
+ * @param test   Fuzz test.
+ * @param files  Input files.
+ * @param next   Shared index of the next input.
+ * @param worker Shared worker state.
+ * @param output Failures output.
+ */
+static void fuzz_worker_run(fuzz_func test, const std::vector<std::string>& files,
+    std::size_t* next, fuzz_worker& worker, std::FILE* output)
+{
+    const unsigned int base = assertion_count;
+
+    for (std::size_t input; (input = __sync_fetch_and_add(next, 1)) < files.size(); )
+    {
+        worker.input = input;
+
+        const std::size_t count = errors.size();
+        fuzz_file(test, files[input]);
+        worker.assertions = assertion_count - base;
+
+        for (std::size_t i = count; i < errors.size(); ++i)
+        {
+            const fuzz_record record = { input, errors[i].kind, errors[i].location,
+                errors[i].message ? errors[i].length : 0 };
+
+            std::fwrite(&record, sizeof(record), 1, output);
+            std::fwrite(errors[i].message, 1, record.length, output);
+            std::fflush(output);
+        }
+    }
+
+    worker.input = files.size();
+
+    // Don't run destructors and exit handlers of the test process
+    std::fflush(NULL);
+    ::_exit(EXIT_SUCCESS);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Replays corpus in forked processes.
+ *
+ * A crashed process is reported as a failure of its input and replaced.
+ * Inputs that couldn't be replayed by any process are replayed here.
+ *
+ * @param test  Fuzz test.
+ * @param files Input files.
+ * @param jobs  Number of processes.
+ */
+static void fuzz_replay_forked(fuzz_func test, const std::vector<std::string>& files,
+    unsigned int jobs)
+{
+    const std::size_t shared_size = sizeof(std::size_t) + jobs * sizeof(fuzz_worker);
+    void* shared = ::mmap(NULL, shared_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    if (shared == MAP_FAILED)
+    {
+        for (std::size_t i = 0; i < files.size(); ++i)
+            fuzz_file(test, files[i]);
+
+        return;
+    }
+
+    std::size_t* const next = static_cast<std::size_t*>(shared);
+    fuzz_worker* const workers = reinterpret_cast<fuzz_worker*>(next + 1);
+    std::vector<pid_t> pids(jobs, -1);
+    std::vector<std::FILE*> outputs(jobs);
+    std::vector<fuzz_failure> failures;
+    unsigned int assertions = 0;
+
+    // Pending output would be written by each process
+    std::fflush(NULL);
+
+    for (unsigned int i = 0; i < jobs; ++i)
+    {
+        outputs[i] = std::tmpfile();
+        workers[i].input = files.size();
+        workers[i].assertions = 0;
+
+        if (outputs[i] && (pids[i] = ::fork()) == 0)
+            fuzz_worker_run(test, files, next, workers[i], outputs[i]);
+    }
+
+    for (bool running = true; running; )
+    {
+        running = false;
+
+        for (unsigned int i = 0; i < jobs; ++i)
+        {
+            if (pids[i] <= 0)
+                continue;
+
+            int status = 0;
+            while (::waitpid(pids[i], &status, 0) < 0 && errno == EINTR)
+                continue;
+
+            pids[i] = -1;
+            assertions += workers[i].assertions;
+
+            const std::size_t input = workers[i].input;
+
+            // Process finished all inputs
+            if (input >= files.size())
+                continue;
+
+            std::ostringstream oss;
+            if (WIFSIGNALED(status))
+                oss << "killed by signal " << WTERMSIG(status) << " (" << ::strsignal(WTERMSIG(status)) << ")";
+            else
+                oss << "exited with status " << WEXITSTATUS(status);
+            oss << "\n    with input = " << files[input];
+
+            fuzz_failure failure;
+            failure.record.input = input;
+            failure.record.kind = failure_assert;
+            failure.record.location = NULL;
+            failure.message = oss.str();
+            failures.push_back(failure);
+
+            // Replace crashed process
+            workers[i].input = files.size();
+            workers[i].assertions = 0;
+            std::fflush(NULL);
+
+            if (*next < files.size() && (pids[i] = ::fork()) == 0)
+                fuzz_worker_run(test, files, next, workers[i], outputs[i]);
+
+            running = running || pids[i] > 0;
+        }
+    }
+
+    // Read failures
+    for (unsigned int i = 0; i < jobs; ++i)
+    {
+        if (!outputs[i])
+            continue;
+
+        std::rewind(outputs[i]);
+
+        fuzz_failure failure;
+        while (std::fread(&failure.record, sizeof(failure.record), 1, outputs[i]) == 1)
+        {
+            failure.message.resize(failure.record.length);
+            if (failure.record.length &&
+                std::fread(&failure.message[0], 1, failure.record.length, outputs[i]) != failure.record.length)
+                break;
+
+            failures.push_back(failure);
+        }
+
+        std::fclose(outputs[i]);
+    }
+
+    std::stable_sort(failures.begin(), failures.end());
+
+    for (std::size_t i = 0; i < failures.size(); ++i)
+    {
+        const fuzz_failure& failure = failures[i];
+        errors.add(failure.record.kind, *current->name, failure.record.location,
+            failure.message.empty() ? NULL : failure.message.data(), failure.message.length());
+        current->failures++;
+    }
+
+    assertion_count += assertions;
+
+    // Inputs left by processes that couldn't be started
+    for (std::size_t input; (input = (*next)++) < files.size(); )
+        fuzz_file(test, files[input]);
+
+    ::munmap(shared, shared_size);
+}
+#endif
+
+/* ************************************************************************ */
+
+/**
+ * @brief Body of the running fuzz test.
+ *
+ * The empty input is replayed first, then all corpus files.
+ */
+static void fuzz_body()
+{
+    const fuzz_test entry = *fuzz_running;
+
+    fuzz_input(entry.test, NULL, 0, "<empty>");
+
+    std::vector<std::string> files;
+    if (!list_corpus(entry.corpus, files))
+    {
+        fail(NULL, "cannot open corpus " + entry.corpus);
+        return;
+    }
+
+#ifdef TESTER_FUZZ_FORK
+    unsigned int jobs = fuzz_jobs;
+    if (!jobs)
+        jobs = static_cast<unsigned int>(std::max(::sysconf(_SC_NPROCESSORS_ONLN), 1L));
+
+    jobs = static_cast<unsigned int>(std::min<std::size_t>(jobs, files.size()));
+
+    // Coverage counters are collected only in the test process
+    if (jobs > 1 && !coverage_enabled)
+    {
+        fuzz_replay_forked(entry.test, files, jobs);
+        return;
+    }
+#endif
+
+    for (std::size_t i = 0; i < files.size(); ++i)
+        fuzz_file(entry.test, files[i]);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief libFuzzer callback.
+ *
+ * Failures are printed and the process is aborted so libFuzzer stores the
+ * input.
+ *
+ * @param data Input data.
+ * @param size Input size.
+ *
+ * @return 0.
+ */
+static int fuzz_one(const unsigned char* data, std::size_t size)
+{
+    const std::size_t count = errors.size();
+    const fuzz_call call = { fuzz_selected, data, size };
+    call_test(call, *fuzz_context->name, *fuzz_context);
+
+    if (errors.size() == count)
+        return 0;
+
+    for (std::size_t i = count; i < errors.size(); ++i)
+        std::cerr << errors[i] << "\n";
+
+    std::abort();
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Runs fuzz test by libFuzzer and exits.
+ *
+ * @param test   Fuzz test.
+ * @param name   Test name.
+ * @param corpus Corpus directory used when no directory is passed to
+ *               libFuzzer.
+ */
+static void fuzz_drive(fuzz_func test, const std::string& name, const std::string& corpus)
+{
+#ifdef TESTER_LIBFUZZER
+    if (LLVMFuzzerRunDriver)
+    {
+        test_context context = { &name, 0, 0, NULL, { 0, 0, 0 }, resource_usage(), 0,
+            std::string(), std::string(), NULL };
+        fuzz_selected = test;
+        fuzz_context = &context;
+        current = &context;
+
+        std::vector<std::string> args(fuzz_args);
+        if (args.empty())
+            args.push_back("tester");
+
+        bool directory = false;
+        for (std::size_t i = 1; i < args.size(); ++i)
+            directory = directory || args[i][0] != '-';
+
+        if (!directory)
+            args.push_back(corpus);
+
+        std::vector<char*> argv;
+        for (std::size_t i = 0; i < args.size(); ++i)
+            argv.push_back(&args[i][0]);
+        argv.push_back(NULL);
+
+        int argc = static_cast<int>(args.size());
+        char** argv_ptr = &argv[0];
+        std::exit(LLVMFuzzerRunDriver(&argc, &argv_ptr, &fuzz_one));
+    }
+#else
+    (void) test;
+    (void) corpus;
+#endif
+
+    std::cerr << "Fuzz test " << name << ": libFuzzer is not linked\n";
+    std::exit(EXIT_FAILURE);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Calls test body if it's on the path of the fuzz test run by
+ * libFuzzer.
+ *
+ * Other tests are skipped. Failures of called bodies are ignored.
+ *
+ * @param test Test.
+ * @param name Test name.
+ */
+static void fuzz_walk(const test_func& test, const std::string& name)
+{
+    const std::string::size_type length = fuzz_path.length();
+
+    if (length)
+        fuzz_path += '/';
+
+    fuzz_path += name;
+
+    if (fuzz_target.length() > fuzz_path.length() &&
+        fuzz_target.compare(0, fuzz_path.length(), fuzz_path) == 0 &&
+        fuzz_target[fuzz_path.length()] == '/')
+    {
+        test_context context = { &name, 0, 0, NULL, { 0, 0, 0 }, resource_usage(), 0,
+            std::string(), std::string(), NULL };
+        test_context* parent = current;
+        current = &context;
+
+        call_test(test, name, context);
+
+        current = parent;
+    }
+
+    fuzz_path.resize(length);
+}
+
+/* ************************************************************************ */
+/* STRESS                                                                   */
+/* ************************************************************************ */
+
+#ifdef CXX11
+
+/// Number of busy waiting iterations before the barrier starts yielding.
+static const unsigned int STRESS_SPIN_LIMIT = 1000000;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Waits until the flag is set.
+ *
+ * It spins first so threads leave the barrier at the same time, then yields
+ * when there are more threads than processors.
+ *
+ * @param flag Flag.
+ */
+static void spin_wait(const std::atomic<bool>& flag) noexcept
+{
+    for (unsigned int spins = 0; !flag.load(std::memory_order_acquire); ++spins)
+    {
+        if (spins >= STRESS_SPIN_LIMIT)
+            std::this_thread::yield();
+#ifdef TESTER_X86_SIMD
+        else
+            _mm_pause();
+#endif
+    }
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Pins the current thread to a processor.
+ *
+ * Threads are distributed over processors allowed for the process.
+ *
+ * @param index Thread index.
+ */
+static void pin_thread(unsigned int index) noexcept
+{
+#ifdef __linux__
+    cpu_set_t allowed;
+    if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        return;
+
+    const int count = CPU_COUNT(&allowed);
+    if (!count)
+        return;
+
+    // Find n-th allowed processor
+    int n = static_cast<int>(index % static_cast<unsigned int>(count));
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (!CPU_ISSET(cpu, &allowed) || n--)
+            continue;
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+        return;
+    }
+#else
+    (void) index;
+#endif
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints stress test result.
+ *
+ * @param os     Output stream.
+ * @param result Stress test result.
+ */
+static void print_stress(std::ostream& os, const stress_result& result)
+{
+    os << "  " << result.ops.size() << " threads, " << result.total << " ops in "
+        << result.seconds * 1000 << " ms, " << result.throughput << " ops/s, fairness "
+        << result.fairness << "\n  ops per thread:";
+
+    for (std::size_t i = 0; i < result.ops.size(); ++i)
+        os << " " << result.ops[i];
+
+    os << "\n";
+}
+
+#endif
+
+/* ************************************************************************ */
+/* PROGRESS                                                                 */
+/* ************************************************************************ */
+
+#ifdef CXX11
+
+/// Status line redraw period.
+static const std::chrono::milliseconds PROGRESS_TICK(100);
+
+/// Period of progress lines when the output isn't a terminal.
+static const std::chrono::seconds PROGRESS_PLAIN_PERIOD(10);
+
+/* ************************************************************************ */
+
+/**
+ * @brief Progress of the test run.
+ *
+ * The running thread updates it at test boundaries, the ticker thread only
+ * formats it. All members are guarded by the mutex.
+ */
+struct progress_state
+{
+    /// Clock type.
+    typedef std::chrono::steady_clock clock;
+
+    /// Guards the state and the terminal.
+    std::mutex mutex;
+
+    /// Wakes the ticker when stopping.
+    std::condition_variable wake;
+
+    /// Ticker thread.
+    std::thread ticker;
+
+    /// If the ticker should stop.
+    bool stopping;
+
+    /// If the status line is redrawn on terminal.
+    bool live;
+
+    /// If the status line is on the screen.
+    bool shown;
+
+    /// Path of the running test.
+    std::string path;
+
+    /// Start times of the running test and its parents.
+    std::vector<clock::time_point> starts;
+
+    /// Start of the run.
+    clock::time_point start;
+
+    /// Time of the last plain progress line.
+    clock::time_point printed;
+
+    /// Number of finished tests.
+    unsigned int done;
+
+    /// Number of failed tests.
+    unsigned int failed;
+
+    /// Total test durations in seconds and number of runs from the previous
+    /// run by test path, a test can be run more times under the same path.
+    std::map<std::string, std::pair<double, unsigned int> > history;
+
+    /// Number of test runs in the previous run.
+    unsigned int history_count;
+
+    /// Previous durations of top-level tests that haven't finished.
+    double remaining;
+
+    /// Previous duration of the running top-level test.
+    double expected;
+
+    /// Test durations of this run.
+    std::vector<std::pair<std::string, double> > durations;
+};
+
+/* ************************************************************************ */
+
+/// Progress of the test run, NULL if disabled.
+static progress_state* progress_info;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Formats duration as minutes and seconds.
+ *
+ * @param os      Output stream.
+ * @param seconds Duration.
+ */
+static void print_duration(std::ostream& os, double seconds)
+{
+    const long total = static_cast<long>(seconds + 0.5);
+    os << total / 60 << ":" << std::setw(2) << std::setfill('0') << total % 60;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Formats progress status.
+ *
+ * @param state Progress state.
+ *
+ * @return Status text.
+ */
+static std::string progress_status(const progress_state& state)
+{
+    const progress_state::clock::time_point now = progress_state::clock::now();
+    const double elapsed = std::chrono::duration<double>(now - state.start).count();
+    const unsigned int total = std::max(state.history_count, state.done);
+
+    std::ostringstream oss;
+    oss << "[" << state.done;
+
+    if (state.history_count)
+        oss << "/" << total;
+
+    oss << "] " << state.failed << " failed, " << std::fixed << std::setprecision(1)
+        << (elapsed > 0 ? state.done / elapsed : 0) << " tests/s";
+
+    // Time left of the running top-level test is estimated by its duration
+    if (state.remaining > 0)
+    {
+        double running = 0;
+        if (!state.starts.empty())
+            running = std::chrono::duration<double>(now - state.starts.front()).count();
+
+        oss << ", ETA ";
+        print_duration(oss, std::max(state.remaining - std::min(running, state.expected), 0.0));
+    }
+
+    if (!state.path.empty())
+        oss << ", " << state.path;
+
+    return oss.str();
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns terminal width.
+ *
+ * @return Number of columns.
+ */
+static std::size_t terminal_width() noexcept
+{
+#ifdef TESTER_POSIX
+    struct winsize size;
+    if (::ioctl(STDERR_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col)
+        return size.ws_col;
+#endif
+    return 80;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Ticker thread, it redraws the status line.
+ *
+ * Status is written into stderr by stdio. std::cerr isn't used because it
+ * flushes std::cout of the running thread.
+ *
+ * @param state Progress state.
+ */
+static void progress_tick(progress_state& state)
+{
+    std::unique_lock<std::mutex> lock(state.mutex);
+
+    while (!state.stopping)
+    {
+        state.wake.wait_for(lock, PROGRESS_TICK);
+
+        if (state.stopping)
+            break;
+
+        if (state.live)
+        {
+            std::string status = progress_status(state);
+            const std::size_t width = terminal_width();
+
+            if (status.length() >= width)
+                status.resize(width - 1);
+
+            std::fprintf(stderr, "\r%s\x1b[K", status.c_str());
+            std::fflush(stderr);
+            state.shown = true;
+        }
+        else if (progress_state::clock::now() - state.printed >= PROGRESS_PLAIN_PERIOD)
+        {
+            std::fprintf(stderr, "Progress: %s\n", progress_status(state).c_str());
+            std::fflush(stderr);
+            state.printed = progress_state::clock::now();
+        }
+    }
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Clears status line from the screen.
+ *
+ * @param state Progress state, its mutex must be locked.
+ */
+static void progress_clear(progress_state& state)
+{
+    if (!state.shown)
+        return;
+
+    std::fputs("\r\x1b[K", stderr);
+    std::fflush(stderr);
+    state.shown = false;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Starts the progress ticker.
+ *
+ * Durations of the previous run are read from `progress_file`.
+ */
+static void progress_begin()
+{
+    if (!progress)
+        return;
+
+    progress_state* state = new progress_state();
+    state->stopping = false;
+#ifdef TESTER_POSIX
+    state->live = ::isatty(STDERR_FILENO) != 0;
+#else
+    state->live = false;
+#endif
+    state->shown = false;
+    state->start = progress_state::clock::now();
+    state->printed = state->start;
+    state->done = 0;
+    state->failed = 0;
+    state->remaining = 0;
+    state->expected = 0;
+    state->history_count = 0;
+
+    std::ifstream file(progress_file.c_str());
+    double seconds;
+    std::string path;
+
+    while (file >> seconds && std::getline(file.ignore(), path))
+    {
+        std::pair<double, unsigned int>& entry = state->history[path];
+        entry.first += seconds;
+        entry.second++;
+        state->history_count++;
+
+        if (path.find('/') == std::string::npos)
+            state->remaining += seconds;
+    }
+
+    progress_info = state;
+    state->ticker = std::thread(progress_tick, std::ref(*state));
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Stops the progress ticker and stores test durations.
+ */
+static void progress_end()
+{
+    progress_state* state = progress_info;
+
+    if (!state)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->stopping = true;
+        progress_clear(*state);
+    }
+
+    state->wake.notify_one();
+    state->ticker.join();
+
+    if (!progress_file.empty())
+    {
+        std::ofstream file(progress_file.c_str(), std::ios::trunc);
+
+        for (std::size_t i = 0; i < state->durations.size(); ++i)
+            file << state->durations[i].second << "\t" << state->durations[i].first << "\n";
+    }
+
+    progress_info = NULL;
+    delete state;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Marks test start.
+ *
+ * @param name Test name.
+ */
+static void progress_enter(const std::string& name)
+{
+    progress_state& state = *progress_info;
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    if (!state.path.empty())
+        state.path += "/";
+
+    state.path += name;
+    state.starts.push_back(progress_state::clock::now());
+
+    if (state.starts.size() == 1)
+    {
+        // Repeated runs of the test are expected to take the same time
+        const std::map<std::string, std::pair<double, unsigned int> >::const_iterator it =
+            state.history.find(name);
+        state.expected = it != state.history.end() ? it->second.first / it->second.second : 0;
+    }
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Marks test end.
+ *
+ * @param failed If test failed.
+ */
+static void progress_leave(bool failed)
+{
+    progress_state& state = *progress_info;
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    const double seconds = std::chrono::duration<double>(
+        progress_state::clock::now() - state.starts.back()).count();
+    state.durations.push_back(std::make_pair(state.path, seconds));
+    state.starts.pop_back();
+
+    if (state.starts.empty())
+    {
+        state.remaining -= state.expected;
+        state.expected = 0;
+    }
+
+    state.done++;
+
+    if (failed)
+        state.failed++;
+
+    const std::string::size_type pos = state.path.rfind('/');
+    state.path.erase(pos == std::string::npos ? 0 : pos);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Writes output of finished test.
+ *
+ * Status line is cleared first, the ticker redraws it. Output isn't sent
+ * to the running parent test.
+ *
+ * @param str Output.
+ */
+static void progress_print(const std::string& str)
+{
+    std::lock_guard<std::mutex> lock(progress_info->mutex);
+    progress_clear(*progress_info);
+
+    std::string* const target = output_target;
+    output_target = NULL;
+    std::cout << str << std::flush;
+    output_target = target;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns if each test is printed when it finishes.
+ *
+ * It's used when progress is shown without terminal.
+ *
+ * @return If each test is printed when it finishes.
+ */
+static bool progress_streaming() noexcept
+{
+    return progress_info && !progress_info->live;
+}
+
+#endif
+
+/* ************************************************************************ */
+/* SKIPPING                                                                 */
+/* ************************************************************************ */
+
+/// Quarantined test paths.
+static std::set<std::string> quarantine_paths;
+
+/* ************************************************************************ */
+
+/// If a quarantined test is running.
+static bool quarantine_active;
+
+/* ************************************************************************ */
+
+/// Path of the running test, it's maintained only with quarantine.
+static std::string test_path;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Loads quarantined test paths.
+ */
+static void quarantine_load()
+{
+    quarantine_paths.clear();
+    quarantine_active = false;
+    test_path.clear();
+
+    if (quarantine_file.empty())
+        return;
+
+    std::ifstream file(quarantine_file.c_str());
+
+    if (!file)
+    {
+        std::cerr << "Unable to read quarantine file '" << quarantine_file << "'\n";
+        return;
+    }
+
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        const std::string::size_type first = line.find_first_not_of(" \t\r");
+
+        // Empty line or comment
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+
+        const std::string::size_type last = line.find_last_not_of(" \t\r");
+        quarantine_paths.insert(line.substr(first, last - first + 1));
+    }
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints test line with result of test that wasn't run.
+ *
+ * @param name   Test name.
+ * @param result Test result.
+ */
+static void print_not_run(const std::string& name, const char* result)
+{
+    std::string line(depth * 2, ' ');
+    line += name;
+
+    const size_t width = name.length() + depth * 2;
+    line.append(width < 50 ? 50 - width : 1, ' ');
+    line += result;
+    line += '\n';
+
+#ifdef CXX11
+    if (progress_info && (!current || progress_streaming()))
+        progress_print(line);
+    else
+#endif
+    if (current)
+        current->report += line;
+    else
+        std::cout << line << std::flush;
+}
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Calculates FNV-1a hash of the test name.
+ *
+ * @param str Name.
+ * @param len Name length.
+ *
+ * @return Hash.
+ */
+static std::size_t hash_name(const char* str, std::size_t len) noexcept
+{
+    std::size_t hash = 2166136261u;
+
+    for (std::size_t i = 0; i < len; ++i)
+        hash = (hash ^ static_cast<unsigned char>(str[i])) * 16777619u;
+
+    return hash;
+}
+
+/* ************************************************************************ */
+
+error_list::error_list()
+    : m_used(0)
+    , m_capacity(0)
+    , m_name_count(0)
+{
+    // Nothing to do
+}
+
+/* ************************************************************************ */
+
+error_list::~error_list()
+{
+    clear();
+}
+
+/* ************************************************************************ */
+
+void error_list::add(failure_kind kind, const std::string& test,
+    const char* location, const char* message, std::size_t length)
+{
+    error_record record;
+    record.kind = kind;
+    record.test = intern(test);
+    record.location = location;
+    record.message = message ? store(message, length) : NULL;
+    record.length = message ? length : 0;
+
+    m_records.push_back(record);
+}
+
+/* ************************************************************************ */
+
+void error_list::clear() noexcept
+{
+    m_records.clear();
+
+    for (std::size_t i = 0; i < m_blocks.size(); ++i)
+        delete[] m_blocks[i];
+
+    m_blocks.clear();
+    m_used = 0;
+    m_capacity = 0;
+    m_names.clear();
+    m_name_count = 0;
+}
+
+/* ************************************************************************ */
+
+void error_list::swap(error_list& other) noexcept
+{
+    m_records.swap(other.m_records);
+    m_blocks.swap(other.m_blocks);
+    std::swap(m_used, other.m_used);
+    std::swap(m_capacity, other.m_capacity);
+    m_names.swap(other.m_names);
+    std::swap(m_name_count, other.m_name_count);
+}
+
+/* ************************************************************************ */
+
+const char* error_list::store(const char* str, std::size_t len)
+{
+    const std::size_t size = len + 1;
+
+    if (m_capacity - m_used < size)
+    {
+        // Big strings get their own block
+        const std::size_t capacity = std::max(size, ARENA_BLOCK_SIZE);
+        m_blocks.push_back(new char[capacity]);
+        m_used = 0;
+        m_capacity = capacity;
+    }
+
+    char* ptr = m_blocks.back() + m_used;
+    std::memcpy(ptr, str, len);
+    ptr[len] = '\0';
+    m_used += size;
+
+    return ptr;
+}
+
+/* ************************************************************************ */
+
+const char* error_list::intern(const std::string& name)
+{
+    // Keep load factor under 1/2
+    if (2 * (m_name_count + 1) > m_names.size())
+    {
+        std::vector<const char*> names(std::max<std::size_t>(64, 2 * m_names.size()));
+
+        for (std::size_t i = 0; i < m_names.size(); ++i)
+        {
+            if (!m_names[i])
+                continue;
+
+            const std::size_t hash = hash_name(m_names[i], std::strlen(m_names[i]));
+
+            std::size_t pos = hash & (names.size() - 1);
+            while (names[pos])
+                pos = (pos + 1) & (names.size() - 1);
+
+            names[pos] = m_names[i];
+        }
+
+        m_names.swap(names);
+    }
+
+    const std::size_t hash = hash_name(name.data(), name.length());
+
+    std::size_t pos = hash & (m_names.size() - 1);
+    while (m_names[pos])
+    {
+        if (name.compare(m_names[pos]) == 0)
+            return m_names[pos];
+
+        pos = (pos + 1) & (m_names.size() - 1);
+    }
+
+    m_names[pos] = store(name.data(), name.length());
+    m_name_count++;
+
+    return m_names[pos];
+}
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Records expectation failure of the current test.
+ *
+ * @param location Static location string. Can be NULL.
+ * @param message  Message. Can be NULL.
+ * @param length   Message length.
+ */
+static void record_expectation(const char* location, const char* message, std::size_t length)
+{
+    static const std::string none;
+
+    // Failure context calls user functions so it's formatted without the lock
+    std::string traced;
+    if (trace_top)
+    {
+        traced = add_trace(message ? std::string(message, length) : std::string());
+        message = traced.data();
+        length = traced.length();
+    }
+
+#ifdef CXX11
+    std::lock_guard<std::mutex> lock(failure_mutex);
+#endif
+
+    if (!current)
+    {
+        errors.add(failure_assert, none, location, message, length);
+        return;
+    }
+
+    if (current->failures < expect_limit)
+        errors.add(failure_assert, *current->name, location, message, length);
+    else
+        current->overflow++;
+
+    current->failures++;
+}
+
+/* ************************************************************************ */
+
+void run_test(test_func test, const std::string& name) noexcept
+{
+    // Only the selected fuzz test is run, bodies on its path are called
+    if (!fuzz_target.empty())
+    {
+        fuzz_walk(test, name);
+        return;
+    }
+
+    // Collect for shuffled run, other tests are run in place
+    if (pending && is_deferrable(test))
+    {
+        pending_test entry;
+        entry.test = test;
+        entry.name = name;
+        pending->push_back(entry);
+        return;
+    }
+
+    // Test path is tracked only for quarantine lookup
+    const std::string::size_type path_length = test_path.length();
+    bool quarantine = false;
+    if (!quarantine_paths.empty())
+    {
+        if (path_length)
+            test_path += '/';
+
+        test_path += name;
+        quarantine = !quarantine_active && quarantine_paths.count(test_path) != 0;
+    }
+
+    // Quarantined test and its child tests are counted and recorded
+    // separately
+    const unsigned int saved_count = test_count;
+    const unsigned int saved_failed = failed_count;
+    if (quarantine)
+    {
+        quarantine_active = true;
+        errors.swap(quarantine_errors);
+    }
+
+    test_count++;
+
+    // Test line is written into parent report
+    std::string line(depth * 2, ' ');
+    line += name;
+
+    const size_t width = name.length() + depth * 2;
+    line.append(width < 50 ? 50 - width : 1, ' ');
+
+    // Status line shows the running test, top-level line is printed later.
+    // Without terminal each test is printed when it finishes.
+#ifdef CXX11
+    const bool live = !current && progress_info && progress_info->live;
+    const bool streaming = progress_streaming();
+#else
+    const bool live = false;
+    const bool streaming = false;
+#endif
+
+    if (!streaming && !live)
+    {
+        if (current)
+            current->report += line;
+        else
+            std::cout << line << std::flush;
+    }
+
+#ifdef CXX11
+    if (progress_info)
+        progress_enter(name);
+#endif
+
+    // Increase depth
+    depth++;
+
+    const size_t err_cnt = errors.size();
+
+    // Set test context
+    test_context context = { &name, 0, 0, NULL, { 0, 0, 0 }, resource_usage(), 0,
+        std::string(), std::string(), NULL };
+    test_context* parent = current;
+    current = &context;
+
+    // Redirect test output
+    std::string* const parent_target = output_target;
+    output_target = capture_output ? &context.output : &context.report;
+
+    const bool capture = capture_output;
+    int saved = -1;
+    if (capture)
+        saved = capture_begin(depth);
+
+    // Sample resources
+    const bool sampling = sample_resources;
+    resource_usage usage = resource_usage();
+    if (sampling)
+    {
+        reset_max_rss();
+        usage = get_resource_usage();
+    }
+
+    if (coverage_enabled)
+        coverage_enter(name);
+
+    // Child tests are collected and run after the test body
+    std::vector<pending_test> children;
+    if (shuffle)
+        pending = &children;
+
+    // Call test
+    call_test(test, name, context);
+
+    pending = NULL;
+
+    if (!children.empty())
+        run_pending(children);
+
+    if (sampling || context.budget)
+    {
+        const resource_usage end = get_test_usage(context);
+
+        if (sampling)
+            resource_sample(usage, end, name);
+
+        if (context.budget)
+            resource_check(context, end);
+
+        if (parent)
+            parent->child_max_rss = std::max(parent->child_max_rss, end.max_rss);
+    }
+
+    // Report failures that weren't stored
+    if (context.overflow)
+    {
+        std::ostringstream oss;
+        oss << context.overflow << " more failures not stored";
+        const std::string msg = oss.str();
+        errors.add(failure_assert, name, NULL, msg.data(), msg.length());
+    }
+
+    if (coverage_enabled)
+        coverage_leave();
+
+    const bool failed = err_cnt != errors.size();
+
+    // Keep captured output of failed test
+    std::string output;
+    if (capture)
+        capture_end(depth, saved, failed, output);
+
+    // Restore test context
+    output_target = parent_target;
+    current = parent;
+
+    if (context.failures)
+        failed_count++;
+
+    // Skipped test isn't counted as run
+    const bool skipped = context.skipped && !failed;
+    if (skipped)
+    {
+        test_count--;
+        skipped_count++;
+    }
+
+    test_path.resize(path_length);
+
+    if (quarantine)
+    {
+        quarantine_count += test_count - saved_count;
+        quarantine_failed_count += failed_count - saved_failed;
+        test_count = saved_count;
+        failed_count = saved_failed;
+
+        errors.swap(quarantine_errors);
+        quarantine_active = false;
+    }
+
+#ifdef CXX11
+    if (progress_info)
+        progress_leave(context.failures != 0);
+#endif
+
+    // Decrease depth
+    depth--;
+
+    // Test result is followed by captured output and child tests report
+    std::string result;
+    std::string& report = parent && !streaming ? parent->report : result;
+
+    if (skipped)
+    {
+        report += "SKIP (";
+        report += context.skipped;
+        report += ")\n";
+    }
+    else
+        report += failed ? "FAIL" : "OK";
+
+    if (!skipped)
+        report += quarantine ? " (quarantined)\n" : "\n";
+
+    if (failed)
+    {
+        report += output;
+        report += context.output;
+    }
+
+    report += context.report;
+
+#ifdef CXX11
+    if (live || streaming)
+        progress_print(line + report);
+    else
+#endif
+    if (!parent)
+        std::cout << report << std::flush;
+}
+
+/* ************************************************************************ */
+
+void skip_test(const char* name, const char* reason) noexcept
+{
+    if (!fuzz_target.empty())
+        return;
+
+    skipped_count++;
+
+    std::string result = "SKIP (";
+    result += reason;
+    result += ")";
+    print_not_run(name, result.c_str());
+}
+
+/* ************************************************************************ */
+
+bool test_skip(const char* reason)
+{
+#ifdef TESTER_NO_EXCEPTIONS
+    if (current)
+        current->skipped = reason;
+
+    return false;
+#else
+    throw skip_error(reason);
+#endif
+}
+
+/* ************************************************************************ */
+
+void run_fuzz_test(fuzz_func test, const std::string& name, const std::string& corpus) noexcept
+{
+    if (!fuzz_target.empty())
+    {
+        if ((fuzz_path.empty() ? name : fuzz_path + "/" + name) == fuzz_target)
+            fuzz_drive(test, name, corpus);
+
+        return;
+    }
+
+    fuzz_test entry;
+    entry.test = test;
+    entry.corpus = corpus;
+
+    // Body is run in place even in shuffle mode so it gets its own entry
+    std::vector<pending_test>* backup = pending;
+    const fuzz_test* parent = fuzz_running;
+    pending = NULL;
+    fuzz_running = &entry;
+
+    run_test(fuzz_body, name);
+
+    fuzz_running = parent;
+    pending = backup;
+}
+
+/* ************************************************************************ */
+
+int run_tests(test_func tests) noexcept
+{
+    if (!fuzz_target.empty())
+    {
+        // Selected fuzz test exits the process
+        tests();
+
+        std::cerr << "Fuzz test not found: " << fuzz_target << "\n";
+
+        if (fuzz_target.find('/') == std::string::npos)
+            std::cerr << "Nested fuzz tests are selected by path, e.g. group/name\n";
+
+        return EXIT_FAILURE;
+    }
+
+    if (shuffle)
+        std::cout << "Shuffle seed: " << shuffle_seed << "\n\n";
+
+    // Start tests
+    start();
+
+    if (shuffle)
+    {
+        shuffle_state = shuffle_seed;
+
+        // Collect top-level tests
+        std::vector<pending_test> roots;
+        pending = &roots;
+        tests();
+        pending = NULL;
+
+        run_pending(roots);
+    }
+    else
+    {
+        // Call tests function
+        tests();
+    }
+
+    // Stop tests
+    stop();
+
+    // Print results
+    print_results();
+
+    return errors.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* ************************************************************************ */
+
+int run_tests(int argc, char** argv, test_func tests) noexcept
+{
+    parse_args(argc, argv);
+
+    return run_tests(tests);
+}
+
+/* ************************************************************************ */
+
+void parse_args(int argc, char** argv)
+{
+    fuzz_args.assign(1, argc > 0 ? argv[0] : "tester");
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+
+        if (arg == "--update-snapshots")
+            update_snapshots = true;
+        else if (arg.compare(0, 11, "--coverage=") == 0)
+            coverage_dir = arg.substr(11);
+        else if (arg == "--capture")
+            capture_output = true;
+        else if (arg == "--shuffle")
+        {
+            shuffle = true;
+            shuffle_seed = static_cast<unsigned long>(std::time(NULL)) ^
+                static_cast<unsigned long>(std::clock());
+        }
+        else if (arg.compare(0, 10, "--shuffle=") == 0)
+        {
+            shuffle = true;
+            shuffle_seed = std::strtoul(arg.c_str() + 10, NULL, 10);
+        }
+        else if (arg == "--resources")
+            sample_resources = true;
+        else if (arg.compare(0, 12, "--resources=") == 0)
+        {
+            sample_resources = true;
+            resource_top = static_cast<unsigned int>(std::atoi(arg.c_str() + 12));
+        }
+        else if (arg == "--progress")
+        {
+            progress = true;
+            progress_file = std::string(argc > 0 ? argv[0] : "tester") + ".durations";
+        }
+        else if (arg.compare(0, 11, "--progress=") == 0)
+        {
+            progress = true;
+            progress_file = arg.substr(11);
+        }
+        else if (arg.compare(0, 13, "--quarantine=") == 0)
+            quarantine_file = arg.substr(13);
+        else if (arg.compare(0, 7, "--jobs=") == 0)
+            fuzz_jobs = static_cast<unsigned int>(std::atoi(arg.c_str() + 7));
+        else if (arg.compare(0, 7, "--fuzz=") == 0)
+            fuzz_target = arg.substr(7);
+        else if (arg.compare(0, 2, "--") != 0)
+            fuzz_args.push_back(arg);
+        else
+            std::cerr << "Unknown option: " << arg << "\n";
+    }
+
+    // Other arguments are libFuzzer options and corpus directories
+    if (fuzz_target.empty())
+    {
+        for (std::size_t i = 1; i < fuzz_args.size(); ++i)
+            std::cerr << "Unknown option: " << fuzz_args[i] << "\n";
+    }
+}
+
+/* ************************************************************************ */
+
+#ifdef CXX11
+stress_result run_stress(const stress_func& body, unsigned int threads, bool pin,
+    unsigned int duration)
+{
+    typedef std::chrono::steady_clock clock;
+
+    if (!threads)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::atomic<unsigned int> arrived(0);
+    std::atomic<bool> started(false);
+    std::atomic<bool> stop(false);
+    clock::time_point start;
+    std::vector<clock::time_point> ends(threads);
+    std::vector<unsigned long long> ops(threads);
+    std::vector<unsigned int> assertions(threads);
+#ifdef TESTER_CATCH
+    std::vector<std::exception_ptr> exceptions(threads);
+#endif
+
+    const std::size_t err_cnt = errors.size();
+    const unsigned int fail_cnt = current ? current->failures : 0;
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+        pool.emplace_back([&, i] {
+            if (pin)
+                pin_thread(i);
+
+            // Operations are counted on the stack of each thread
+            stress_thread thread = { i, threads, 0, &stop };
+
+            // The last thread releases the barrier
+            if (arrived.fetch_add(1) + 1 == threads)
+            {
+                start = clock::now();
+                started.store(true, std::memory_order_release);
+            }
+            else
+                spin_wait(started);
+
+#ifndef TESTER_CATCH
+            body(thread);
+#else
+            try
+            {
+                body(thread);
+            }
+            catch (...)
+            {
+                exceptions[i] = std::current_exception();
+            }
+#endif
+
+            ends[i] = clock::now();
+            ops[i] = thread.ops;
+            assertions[i] = assertion_count;
+        });
+    }
+
+    if (duration)
+    {
+        spin_wait(started);
+        std::this_thread::sleep_for(std::chrono::milliseconds(duration));
+        stop = true;
+    }
+
+    for (std::size_t i = 0; i < pool.size(); ++i)
+        pool[i].join();
+
+#ifdef TESTER_CATCH
+    // Record failures as they would be recorded in the test thread
+    static const std::string none;
+    test_context unnamed = { &none, 0, 0, NULL, { 0, 0, 0 }, resource_usage(), 0,
+        std::string(), std::string(), NULL };
+    test_context& context = current ? *current : unnamed;
+
+    for (std::size_t i = 0; i < exceptions.size(); ++i)
+    {
+        if (exceptions[i])
+            call_test([&] { std::rethrow_exception(exceptions[i]); }, *context.name, context);
+    }
+#endif
+
+    stress_result result;
+    result.ops = ops;
+    result.total = 0;
+
+    // Failures over the expectation limit are counted but not stored
+    result.failures = current
+        ? current->failures - fail_cnt
+        : static_cast<unsigned int>(errors.size() - err_cnt);
+
+    double squares = 0;
+    clock::time_point end = start;
+
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+        result.total += ops[i];
+        squares += static_cast<double>(ops[i]) * static_cast<double>(ops[i]);
+        assertion_count += assertions[i];
+        end = std::max(end, ends[i]);
+    }
+
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.throughput = result.seconds > 0 ? result.total / result.seconds : 0;
+    result.fairness = squares > 0
+        ? static_cast<double>(result.total) * result.total / (threads * squares)
+        : 1;
+
+    print_stress(std::cout, result);
+
+    return result;
+}
+#endif
 
 /* ************************************************************************ */
-/* INCLUDES                                                                 */
+
+/**
+ * @brief Runs two tests in given order.
+ *
+ * On POSIX systems the tests are run in a forked process, so both orders
+ * start from the state before the check. Output of the process is dropped.
+ *
+ * @param first       First test.
+ * @param first_name  First test name.
+ * @param second      Second test.
+ * @param second_name Second test name.
+ *
+ * @return Bit 0 is set if the first test failed, bit 1 if the second test
+ *         failed. -1 if the process crashed.
+ */
+static int isolation_run(const test_func& first, const std::string& first_name,
+    const test_func& second, const std::string& second_name)
+{
+#ifdef TESTER_POSIX
+    // Buffered output would be written by both processes
+    std::cout.flush();
+    std::fflush(NULL);
+
+    const pid_t pid = ::fork();
+
+    if (pid > 0)
+    {
+        int status = 0;
+        while (::waitpid(pid, &status, 0) < 0 && errno == EINTR)
+            continue;
+
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+
+    if (pid == 0)
+    {
+        const int null = ::open("/dev/null", O_WRONLY);
+        if (null >= 0)
+        {
+            ::dup2(null, STDOUT_FILENO);
+            ::dup2(null, STDERR_FILENO);
+        }
+
+        // Coverage files and progress ticker belong to the test process
+        coverage_enabled = false;
+#ifdef CXX11
+        progress_info = NULL;
+#endif
+    }
+#endif
+
+    int result = 0;
+
+    std::size_t err_cnt = errors.size();
+    run_test(first, first_name);
+    if (err_cnt != errors.size())
+        result |= 1;
+
+    err_cnt = errors.size();
+    run_test(second, second_name);
+    if (err_cnt != errors.size())
+        result |= 2;
+
+#ifdef TESTER_POSIX
+    // Don't run destructors and exit handlers of the test process
+    if (pid == 0)
+        ::_exit(result);
+#endif
+
+    return result;
+}
+
 /* ************************************************************************ */
 
-// Declaration
-#include "tester.hpp"
+/**
+ * @brief Returns result of a test run by isolation_run.
+ *
+ * @param result Result of the order.
+ * @param bit    Bit of the test.
+ *
+ * @return Result string.
+ */
+static const char* isolation_result(int result, int bit) noexcept
+{
+    if (result < 0)
+        return "CRASH";
 
-// C++
-#include <cstdlib>
-#include <iostream>
-#include <typeinfo>
-#include <sstream>
-#include <iomanip>
+    return (result & bit) ? "FAIL" : "OK";
+}
 
 /* ************************************************************************ */
 
-namespace tester {
+void check_isolation(test_func first, const std::string& first_name,
+    test_func second, const std::string& second_name) noexcept
+{
+    // Tests are run in given order even in shuffle mode
+    std::vector<pending_test>* backup = pending;
+    pending = NULL;
+
+    const int forward = isolation_run(first, first_name, second, second_name);
+    const int backward = isolation_run(second, second_name, first, first_name);
+
+    pending = backup;
+
+    // Each test has the same result in both orders
+    if (forward >= 0 && backward >= 0 &&
+        (forward & 1) == (backward >> 1 & 1) && (forward >> 1 & 1) == (backward & 1))
+    {
+        assertion_count++;
+        return;
+    }
+
+    std::ostringstream oss;
+    oss << "order dependency: " << first_name << ", " << second_name << ": "
+        << isolation_result(forward, 1) << ", " << isolation_result(forward, 2)
+        << "; " << second_name << ", " << first_name << ": "
+        << isolation_result(backward, 1) << ", " << isolation_result(backward, 2);
+
+    const std::string detail = oss.str();
+    record_expectation(NULL, detail.data(), detail.length());
+}
 
 /* ************************************************************************ */
-/* VARIABLES                                                                */
+
+bool test_assert(bool res, const std::string& errstr)
+{
+    if (res)
+        assertion_count++;
+    else
+        fail(NULL, errstr);
+
+    return res;
+}
+
 /* ************************************************************************ */
 
-///Assertion counter.
-unsigned int assertion_count;
+void assert_failed(const char* errstr)
+{
+    fail(errstr, std::string());
+}
 
 /* ************************************************************************ */
 
-/// Test counter.
-unsigned int test_count;
+bool test_array_eq(const char* lhs, const char* rhs, std::size_t n, const char* errstr)
+{
+    return array_eq(lhs, rhs, n, errstr);
+}
 
 /* ************************************************************************ */
 
-/// Error list.
-std::vector<std::string> errors;
+bool test_array_eq(const signed char* lhs, const signed char* rhs, std::size_t n, const char* errstr)
+{
+    return array_eq(lhs, rhs, n, errstr);
+}
 
 /* ************************************************************************ */
 
-/// Tests start time.
-time_point start_time;
+bool test_array_eq(const unsigned char* lhs, const unsigned char* rhs, std::size_t n, const char* errstr)
+{
+    return array_eq(lhs, rhs, n, errstr);
+}
 
 /* ************************************************************************ */
 
-/// Tests stop time.
-time_point stop_time;
+bool test_array_eq(const short* lhs, const short* rhs, std::size_t n, const char* errstr)
+{
+    return array_eq(lhs, rhs, n, errstr);
+}
 
 /* ************************************************************************ */
 
-/// Test call depth.
-static unsigned int depth;
+bool test_array_eq(const unsigned short* lhs, const unsigned short* rhs, std::size_t n, const char* errstr)
+{
+    return array_eq(lhs, rhs, n, errstr);
+}
 
 /* ************************************************************************ */
-/* FUNCTIONS                                                                */
+
+bool test_array_eq(const int* lhs, const int* rhs, std::size_t n, const char* errstr)
+{
+    return array_eq(lhs, rhs, n, errstr);
+}
+
 /* ************************************************************************ */
 
-void run_test(test_func test, const std::string& name) noexcept
+bool test_array_eq(const unsigned int* lhs, const unsigned int* rhs, std::size_t n, const char* errstr)
 {
-    test_count++;
+    return array_eq(lhs, rhs, n, errstr);
+}
 
-    for (size_t i = 0; i < depth; ++i)
-        std::cout << "  ";
+/* ************************************************************************ */
 
-    // Print test name
-    std::cout << name;
+bool test_array_eq(const long* lhs, const long* rhs, std::size_t n, const char* errstr)
+{
+    return array_eq(lhs, rhs, n, errstr);
+}
 
-    const size_t space = 50 - name.length() - depth * 2;
-    for (size_t i = 0; i < space; ++i)
-        std::cout << " ";
+/* ************************************************************************ */
 
-    // Backup output buffer
-    std::streambuf* old = std::cout.rdbuf();
-    std::stringbuf strbuf;
-    std::cout.rdbuf(&strbuf);
+bool test_array_eq(const unsigned long* lhs, const unsigned long* rhs, std::size_t n, const char* errstr)
+{
+    return array_eq(lhs, rhs, n, errstr);
+}
 
-    // Increase depth
-    depth++;
+/* ************************************************************************ */
 
-    const size_t err_cnt = errors.size();
+#ifdef CXX11
+bool test_array_eq(const long long* lhs, const long long* rhs, std::size_t n, const char* errstr)
+{
+    return array_eq(lhs, rhs, n, errstr);
+}
+
+/* ************************************************************************ */
+
+bool test_array_eq(const unsigned long long* lhs, const unsigned long long* rhs, std::size_t n, const char* errstr)
+{
+    return array_eq(lhs, rhs, n, errstr);
+}
+
+/* ************************************************************************ */
+#endif
+
+bool test_array_eq(const float* lhs, const float* rhs, std::size_t n, const char* errstr)
+{
+    return test_array_near(lhs, rhs, n, 0, errstr);
+}
+
+/* ************************************************************************ */
+
+bool test_array_eq(const double* lhs, const double* rhs, std::size_t n, const char* errstr)
+{
+    return test_array_near(lhs, rhs, n, 0, errstr);
+}
+
+/* ************************************************************************ */
+
+bool test_array_near(const float* lhs, const float* rhs, std::size_t n, double tol, const char* errstr)
+{
+    const std::size_t pos = get_array_kernels().floats(lhs, rhs, n, static_cast<float>(tol));
+
+    if (pos != n)
+        return array_failed(lhs, rhs, pos, n, tol, errstr);
+
+    assertion_count++;
+    return true;
+}
+
+/* ************************************************************************ */
+
+bool test_array_near(const double* lhs, const double* rhs, std::size_t n, double tol, const char* errstr)
+{
+    const std::size_t pos = get_array_kernels().doubles(lhs, rhs, n, tol);
+
+    if (pos != n)
+        return array_failed(lhs, rhs, pos, n, tol, errstr);
+
+    assertion_count++;
+    return true;
+}
+
+/* ************************************************************************ */
+
+bool test_snapshot(const void* data, std::size_t size, const std::string& path, const char* errstr)
+{
+    const unsigned char* actual = static_cast<const unsigned char*>(data);
+    std::size_t pos = 0;
+    std::size_t common = 0;
+    bool found = false;
+    bool equal = false;
 
-    try
-    {
-        // Call test
-        test();
-    }
-    catch (const assert_error& e)
     {
-        errors.push_back(name + ": " + std::string(e.what()));
+        const mapped_file golden(path);
+        found = golden.is_open();
+
+        if (found)
+        {
+            const unsigned char* expected = golden.data();
+            common = std::min(size, golden.size());
+            const mismatch_bytes_func mismatch = get_array_kernels().bytes;
+
+            // Compare in chunks, pages of the golden file are read sequentially
+            for (pos = 0; pos < common; )
+            {
+                const std::size_t len = std::min(SNAPSHOT_CHUNK_SIZE, common - pos);
+                const std::size_t diff = mismatch(expected + pos, actual + pos, len);
+                pos += diff;
+
+                if (diff != len)
+                    break;
+            }
+
+            equal = pos == common && size == golden.size();
+
+            if (!equal && !update_snapshots)
+            {
+                std::ostringstream oss;
+                const std::size_t line = 1 + std::count(actual, actual + pos, '\n');
+
+                oss << "snapshot '" << path << "' differs at offset " << pos
+                    << " (line " << line << ")";
+
+                if (size != golden.size())
+                    oss << ", expected size " << golden.size() << ", actual size " << size;
+
+                oss << ": expected ";
+                print_context(oss, expected, golden.size(), pos);
+                oss << ", actual ";
+                print_context(oss, actual, size, pos);
+
+                fail(errstr, oss.str());
+                return false;
+            }
+        }
     }
-    catch (const std::exception& e)
+
+    if (equal)
     {
-        errors.push_back("Uncaught exception of type "
-            "'" + std::string(typeid(e).name()) + "' with error: " +
-            std::string(e.what()));
+        assertion_count++;
+        return true;
     }
-    catch (...)
+
+    if (update_snapshots)
     {
-        errors.push_back("Unknown exception type caught");
+        if (!write_file(path, data, size))
+        {
+            fail(errstr, "unable to write snapshot '" + path + "'");
+            return false;
+        }
+
+        assertion_count++;
+        return true;
     }
 
-    // Decrease depth
-    depth--;
+    fail(errstr, "snapshot '" + path + "' not found");
+    return false;
+}
 
-    // Reset buffer
-    std::cout.rdbuf(old);
+/* ************************************************************************ */
 
-    if (err_cnt == errors.size())
-        std::cout << "OK";
-    else
-        std::cout << "FAIL";
+bool test_snapshot(const std::string& str, const std::string& path, const char* errstr)
+{
+    return test_snapshot(str.data(), str.length(), path, errstr);
+}
 
-    std::cout << "\n";
+/* ************************************************************************ */
 
-    // Print childs output
-    std::cout << strbuf.str();
+void test_resource_budget(long memory, long faults, long switches, const char* errstr)
+{
+    if (!current)
+        return;
 
-    // Flush buffer
-    std::cout.flush();
+    current->budget = errstr;
+    current->budget_limits[0] = memory;
+    current->budget_limits[1] = faults;
+    current->budget_limits[2] = switches;
+    current->child_max_rss = 0;
+    reset_max_rss();
+    current->budget_start = get_resource_usage();
 }
 
 /* ************************************************************************ */
 
-int run_tests(test_func tests) noexcept
+resource_usage get_resource_usage()
 {
-    // Start tests
-    start();
+    resource_usage usage = resource_usage();
 
-    // Call tests function
-    tests();
+#ifdef TESTER_POSIX
+    struct rusage ru;
+    if (::getrusage(RUSAGE_SELF, &ru) == 0)
+    {
+#ifdef __APPLE__
+        // Reported in bytes
+        usage.max_rss = ru.ru_maxrss / 1024;
+#else
+        usage.max_rss = ru.ru_maxrss;
+#endif
+        usage.minor_faults = ru.ru_minflt;
+        usage.major_faults = ru.ru_majflt;
+        usage.voluntary_switches = ru.ru_nvcsw;
+        usage.involuntary_switches = ru.ru_nivcsw;
+    }
+#endif
 
-    // Stop tests
-    stop();
+#ifdef __linux__
+    if (std::FILE* file = std::fopen("/proc/self/statm", "r"))
+    {
+        long size = 0;
+        long resident = 0;
 
-    // Print results
-    print_results();
+        if (std::fscanf(file, "%ld %ld", &size, &resident) == 2)
+            usage.rss = resident * (::sysconf(_SC_PAGESIZE) / 1024);
 
-    return errors.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+        std::fclose(file);
+    }
+#endif
+
+    return usage;
 }
 
 /* ************************************************************************ */
 
-void test_assert(bool res, const std::string& errstr)
+void test_expect(bool res, const std::string& errstr)
 {
     if (res)
         assertion_count++;
     else
-        throw assert_error(errstr);
+        record_expectation(NULL, errstr.data(), errstr.length());
+}
+
+/* ************************************************************************ */
+
+void expect_failed(const char* errstr)
+{
+    record_expectation(errstr, NULL, 0);
+}
+
+/* ************************************************************************ */
+
+std::ostream& operator<<(std::ostream& os, const error_record& record)
+{
+    switch (record.kind)
+    {
+    case failure_assert:
+        os << record.test << ": ";
+        if (record.location)
+            os << record.location;
+        // Failure context starts on a new line
+        if (record.location && record.message && record.message[0] != '\n')
+            os << ": ";
+        if (record.message)
+            os.write(record.message, record.length);
+        break;
+
+    case failure_exception:
+        os << "Uncaught exception of type '" << record.location << "' with error: ";
+        os.write(record.message, record.length);
+        break;
+
+    case failure_unknown:
+        os << "Unknown exception type caught";
+        if (record.message)
+            os.write(record.message, record.length);
+        break;
+    }
+
+    return os;
 }
 
 /* ************************************************************************ */
@@ -192,8 +4591,43 @@ void start()
     depth = 0;
     errors.clear();
     test_count = 0;
+    failed_count = 0;
+    skipped_count = 0;
+    quarantine_count = 0;
+    quarantine_failed_count = 0;
+    quarantine_errors.clear();
+    quarantine_load();
+
+    for (int i = 0; i < resource_count; ++i)
+        resource_lists[i].clear();
+
+    // Output of running tests is sent to them
+    if (!output_redirect)
+        output_redirect = new output_buffer(std::cout.rdbuf());
+
+    if (std::cout.rdbuf() != output_redirect)
+        output_original = std::cout.rdbuf(output_redirect);
+
+#ifdef TESTER_POSIX
+    if (capture_output && output_descriptor < 0)
+    {
+        std::fflush(stdout);
+        output_descriptor = ::dup(STDOUT_FILENO);
+    }
+
+    output_redirect->set_descriptor(capture_output ? output_descriptor : -1);
+#endif
+
     start_time = get_time();
     stop_time = time_point();
+    coverage_start();
+
+#ifdef CXX11
+    progress_begin();
+#else
+    if (progress)
+        std::cerr << "Progress display requires C++11\n";
+#endif
 }
 
 /* ************************************************************************ */
@@ -201,6 +4635,17 @@ void start()
 void stop()
 {
     stop_time = get_time();
+    coverage_stop();
+
+    if (output_original)
+    {
+        std::cout.rdbuf(output_original);
+        output_original = NULL;
+    }
+
+#ifdef CXX11
+    progress_end();
+#endif
 }
 
 /* ************************************************************************ */
@@ -217,9 +4662,33 @@ void print_results()
     // Print test results
     std::cout << "\n";
     std::cout << "Time      : " << passed << " ms\n";
-    std::cout << "Tests     : " << (test_count - errors.size()) << "/" << test_count << "\n";
+    std::cout << "Tests     : " << (test_count - failed_count) << "/" << test_count << "\n";
+
+    if (skipped_count)
+        std::cout << "Skipped   : " << skipped_count << "\n";
+
+    if (quarantine_count)
+    {
+        std::cout << "Quarantine: " << (quarantine_count - quarantine_failed_count)
+            << "/" << quarantine_count << "\n";
+    }
+
     std::cout << "Assertions: " << assertion_count << "\n\n";
 
+    if (sample_resources)
+        resource_print();
+
+    // Quarantined failures don't fail the run
+    if (!quarantine_errors.empty())
+    {
+        std::cerr << "Quarantined errors: \n";
+
+        for (std::size_t i = 0; i < quarantine_errors.size(); ++i)
+            std::cerr << "  " << quarantine_errors[i] << "\n";
+
+        std::cerr << "\n";
+    }
+
     // Some errors found
     if (!errors.empty())
     {
@@ -231,7 +4700,7 @@ void print_results()
             std::cerr << "  " << error << "\n";
 #else
         // How I like for-range loops
-        for (std::vector<std::string>::const_iterator it = errors.begin(),
+        for (error_list::const_iterator it = errors.begin(),
             ite = errors.end(); it != ite; ++it)
         {
             std::cerr << "  " << *it << "\n";
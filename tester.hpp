@@ -34,12 +34,17 @@
 /* ************************************************************************ */
 
 // C++
+#include <cstddef>
+#include <cstring>
+#include <string>
 #include <stdexcept>
 #include <vector>
+#include <ostream>
 #include <functional>
 
 #if __cplusplus >= 201103L
 #include <chrono>
+#include <atomic>
 #else
 #include <ctime>
 #endif
@@ -66,6 +71,39 @@
 
 /* ************************************************************************ */
 
+/**
+ * @brief Exception-free failure propagation.
+ *
+ * Failed assertions are recorded into the current test and return from the
+ * enclosing function instead of throwing. The function must return void and
+ * a failure inside a helper function doesn't stop its caller. It's enabled
+ * automatically when exceptions are disabled and must be defined equally for
+ * the library and the tests.
+ */
+#if !defined(TESTER_NO_EXCEPTIONS) && \
+    ((defined(__GNUC__) && !defined(__EXCEPTIONS)) || \
+     (defined(_MSC_VER) && !defined(_CPPUNWIND)))
+#define TESTER_NO_EXCEPTIONS
+#endif
+
+/* ************************************************************************ */
+
+/**
+ * @brief Thread-local storage specifier.
+ *
+ * GNU `__thread` is preferred because `thread_local` variables shared
+ * between translation units are accessed through a wrapper function.
+ */
+#if defined(__GNUC__)
+#define TESTER_THREAD_LOCAL __thread
+#elif defined(CXX11)
+#define TESTER_THREAD_LOCAL thread_local
+#else
+#define TESTER_THREAD_LOCAL
+#endif
+
+/* ************************************************************************ */
+
 /**
  * @brief Converts argument into a string literal.
  *
@@ -88,6 +126,41 @@
 
 /* ************************************************************************ */
 
+/**
+ * @brief Concatenates arguments.
+ *
+ * @param a First token.
+ * @param b Second token.
+ *
+ * @return Token ab.
+ */
+#define CONCAT(a, b) a ## b
+
+/* ************************************************************************ */
+
+/**
+ * @brief Evaluate arguments and concatenates them.
+ *
+ * @param a First token.
+ * @param b Second token.
+ *
+ * @return Evaluated tokens concatenated.
+ */
+#define XCONCAT(a, b) CONCAT(a, b)
+
+/* ************************************************************************ */
+
+/**
+ * @brief Unique number for names of local variables.
+ */
+#ifdef __COUNTER__
+#define TESTER_UNIQUE __COUNTER__
+#else
+#define TESTER_UNIQUE __LINE__
+#endif
+
+/* ************************************************************************ */
+
 /**
  * @brief Create test function name.
  *
@@ -124,6 +197,35 @@
 
 /* ************************************************************************ */
 
+/**
+ * @brief Create an expression that skips disabled test.
+ *
+ * The test isn't run but it's still compiled and it's counted as skipped.
+ *
+ * @param name Test name.
+ *
+ * @return Test skipping expression.
+ */
+#define TEST_DISABLED(name) \
+    ((void) TEST_NAME(name), ::tester::skip_test(# name, "disabled"))
+
+/* ************************************************************************ */
+
+/**
+ * @brief Create an expression that calls test only if condition is true.
+ *
+ * Otherwise the test is counted as skipped.
+ *
+ * @param cond Condition.
+ * @param name Test name.
+ *
+ * @return Conditional test calling expression.
+ */
+#define TEST_RUN_IF(cond, name) \
+    ((cond) ? TEST_RUN(name) : ::tester::skip_test(# name, # cond " is false"))
+
+/* ************************************************************************ */
+
 /**
  * @brief Declare and Run test with given name.
  *
@@ -138,6 +240,68 @@
 
 /* ************************************************************************ */
 
+/**
+ * @brief Create fuzz test function declaration.
+ *
+ * The function is called with each input. It's compatible with libFuzzer
+ * LLVMFuzzerTestOneInput except it returns nothing.
+ *
+ * @param name Test name.
+ * @param data Name of the input data parameter.
+ * @param size Name of the input size parameter.
+ *
+ * @return Prototype of the fuzz test function.
+ */
+#define FUZZ_TEST(name, data, size) \
+    void TEST_NAME(name)(const unsigned char* data, std::size_t size)
+
+/* ************************************************************************ */
+
+/**
+ * @brief Create an expression that calls fuzz test.
+ *
+ * @param name   Test name.
+ * @param corpus Corpus directory.
+ *
+ * @return Fuzz test calling expression.
+ */
+#define FUZZ_RUN(name, corpus) \
+    ::tester::run_fuzz_test(TEST_NAME(name), # name, corpus)
+
+/* ************************************************************************ */
+
+/**
+ * @brief Evaluates assertion call.
+ *
+ * Without exceptions it returns from the enclosing function when the
+ * assertion fails.
+ *
+ * @param call Assertion function call returning true on success.
+ */
+#ifdef TESTER_NO_EXCEPTIONS
+#define TEST_CHECK(call) \
+    do { if (!(call)) return; } while (false)
+#else
+#define TEST_CHECK(call) \
+    call
+#endif
+
+/* ************************************************************************ */
+
+/**
+ * @brief Check if two tests don't depend on their order.
+ *
+ * Tests are run in both orders, each from the same state on POSIX systems,
+ * and a failure is recorded into the current test if their results differ.
+ *
+ * @param first  First test name.
+ * @param second Second test name.
+ */
+#define TEST_ISOLATION(first, second) \
+    ::tester::check_isolation(TEST_NAME(first), # first, TEST_NAME(second), # second)
+
+/* ************************************************************************ */
+
 /**
  * @brief Test if given expression is true.
  *
@@ -147,7 +311,17 @@
  *                     about tested expression and it's position.
  */
 #define ASSERT(expr) \
-    ::tester::test_assert(expr, "(" # expr ") at line " XSTR(__LINE__))
+    TEST_CHECK(::tester::test_assert(expr, "(" # expr ") at line " XSTR(__LINE__)))
+
+/* ************************************************************************ */
+
+/**
+ * @brief Stops the current test and marks it as skipped.
+ *
+ * @param reason Reason string with static storage duration.
+ */
+#define SKIP(reason) \
+    TEST_CHECK(::tester::test_skip(reason))
 
 /* ************************************************************************ */
 
@@ -177,186 +351,1492 @@
 
 /* ************************************************************************ */
 
-namespace tester {
-
-/* ************************************************************************ */
-/* TYPES                                                                    */
-/* ************************************************************************ */
-
 /**
- * @brief Type that represents a point in time.
+ * @brief Test arrays equality.
+ *
+ * Arrays are compared with vectorized code. On failure the first differing
+ * elements and maximum errors are reported.
+ *
+ * @param lhs Pointer to the first element of the left array.
+ * @param rhs Pointer to the first element of the right array.
+ * @param n   Number of elements.
  */
-#ifdef CXX11
-using time_point = std::chrono::high_resolution_clock::time_point;
-#else
-typedef std::clock_t time_point;
-#endif
+#define ASSERT_ARRAY_EQ(lhs, rhs, n) \
+    TEST_CHECK(::tester::test_array_eq(lhs, rhs, n, "(" # lhs ", " # rhs ") at line " XSTR(__LINE__)))
 
 /* ************************************************************************ */
 
 /**
- * @brief Callback test function type.
+ * @brief Test if floating point arrays are equal within tolerance.
+ *
+ * @param lhs Pointer to the first element of the left array.
+ * @param rhs Pointer to the first element of the right array.
+ * @param n   Number of elements.
+ * @param tol Maximum allowed absolute difference.
  */
-#ifdef CXX11
-using test_func = std::function<void()>;
-#else
-typedef void (*test_func)();
-#endif
+#define ASSERT_ARRAY_NEAR(lhs, rhs, n, tol) \
+    TEST_CHECK(::tester::test_array_near(lhs, rhs, n, tol, "(" # lhs ", " # rhs ") at line " XSTR(__LINE__)))
 
-/* ************************************************************************ */
-/* VARIABLES                                                                */
 /* ************************************************************************ */
 
-/// Assertion counter.
-extern unsigned int assertion_count;
+/**
+ * @brief Test string against a golden file.
+ *
+ * With `--update-snapshots` option the golden file is rewritten instead.
+ *
+ * @param str  Tested string.
+ * @param path Path to the golden file.
+ */
+#define ASSERT_SNAPSHOT(str, path) \
+    TEST_CHECK(::tester::test_snapshot(str, path, "(" # str ", " # path ") at line " XSTR(__LINE__)))
 
 /* ************************************************************************ */
 
-/// Test counter.
-extern unsigned int test_count;
+/**
+ * @brief Test buffer against a golden file.
+ *
+ * @param data Pointer to tested data.
+ * @param size Data size in bytes.
+ * @param path Path to the golden file.
+ */
+#define ASSERT_SNAPSHOT_BUFFER(data, size, path) \
+    TEST_CHECK(::tester::test_snapshot(data, size, path, "(" # data ", " # path ") at line " XSTR(__LINE__)))
 
 /* ************************************************************************ */
 
-/// Error list.
-extern std::vector<std::string> errors;
+/**
+ * @brief Limit resources used by the rest of the test.
+ *
+ * Usage is measured from this point to the end of the test. Negative limit
+ * means unlimited.
+ *
+ * @param memory   Maximum memory growth in kB.
+ * @param faults   Maximum number of page faults (minor and major).
+ * @param switches Maximum number of context switches.
+ */
+#define RESOURCE_BUDGET(memory, faults, switches) \
+    ::tester::test_resource_budget(memory, faults, switches, "resource budget at line " XSTR(__LINE__))
 
 /* ************************************************************************ */
 
-/// Tests start time.
-extern time_point start_time;
+/**
+ * @brief Test if given expression is true without stopping the test.
+ *
+ * Failure is recorded and the test continues. Number of stored failures per
+ * test is limited by `expect_limit`.
+ *
+ * @param expr Tested expression.
+ */
+#define EXPECT(expr) \
+    ::tester::test_expect(expr, "(" # expr ") at line " XSTR(__LINE__))
 
 /* ************************************************************************ */
 
-/// Tests stop time.
-extern time_point stop_time;
+/**
+ * @brief Test values equality without stopping the test.
+ *
+ * @param lhs Left operand.
+ * @param rhs Right operand.
+ *
+ * @return lhs == rhs expectation.
+ */
+#define EXPECT_EQ(lhs, rhs) \
+    EXPECT(lhs == rhs)
 
-/* ************************************************************************ */
-/* CLASSES                                                                  */
 /* ************************************************************************ */
 
 /**
- * @brief Assertion error.
+ * @brief Test values unequality without stopping the test.
  *
- * This exception type is used for indication the assertion failed.
+ * @param lhs Left operand.
+ * @param rhs Right operand.
+ *
+ * @return lhs != rhs expectation.
  */
-class assert_error : public std::runtime_error
-{
-
-// Public Ctors
-public:
-
-
-    /**
-     * @brief Creates an assertion error.
-     *
-     * @param what Error message.
-     */
-    explicit assert_error(const std::string& what)
-        : std::runtime_error(what)
-    {}
-
-
-    /**
-     * @brief Creates an assertion error.
-     *
-     * @param what Error message.
-     */
-    explicit assert_error(const char* what)
-        : std::runtime_error(what)
-    {}
+#define EXPECT_NEQ(lhs, rhs) \
+    EXPECT(lhs != rhs)
 
-};
-
-/* ************************************************************************ */
-/* FUNCTIONS                                                                */
 /* ************************************************************************ */
 
 /**
- * @brief Performs a test.
- *
- * Function calls given test function and prints it's call result onto
- * standard output. The output have format where test name is printed and
- * after that is printed the test result (OK or FAIL).
+ * @brief Adds a variable to the failure context of the rest of the scope.
  *
- * Test can be called recursive and function is able to handle that. It's
- * a simple way to group tests.
+ * Only a pointer to the variable is stored, it's printed when an assertion
+ * or expectation fails in the scope. The printed value is the value at the
+ * time of the failure so it can be declared before a loop. Argument must
+ * be a variable or a string literal.
  *
- * @param test Pointer to test function. It can be lambda under C++11.
- * @param name Test name.
+ * @code
+ * for (int i = 0; i < n; ++i)
+ * {
+ *     SCOPED_TRACE(i);
+ *     ASSERT(check(i));  // (check(i)) at line 12
+ * }                      //     with i = 7
+ * @endcode
  *
- * @see TEST_RUN
+ * @param value Variable or string literal.
  */
-void run_test(test_func test, const std::string& name) noexcept;
+#define SCOPED_TRACE(value) \
+    const ::tester::scoped_trace XCONCAT(tester_trace_, TESTER_UNIQUE)( \
+        ::tester::trace_data(value), ::tester::trace_printer(value), # value)
 
 /* ************************************************************************ */
 
 /**
- * @brief Performs tests.
+ * @brief Adds a message to the failure context of the rest of the scope.
  *
- * This function handle the whole testing system and can be used as only one
- * function call in the main function. The function calls sequentialy
- * following functions:
- *
- *  - start()
- *  - tests()
- *  - stop()
- *  - print_results()
+ * The message is a stream insertion expression that is evaluated only
+ * when an assertion or expectation fails in the scope. Variables are
+ * captured by reference.
  *
- * @param test A function that tests all required tests.
+ * @code
+ * INFO("row " << i << ", column " << j);
+ * @endcode
  *
- * @return Tests result. Can be used directly as program exit status.
+ * @param ... Stream insertion expression.
  */
-int run_tests(test_func tests) noexcept;
+#ifdef CXX11
+#define INFO(...) \
+    TESTER_INFO(TESTER_UNIQUE, __VA_ARGS__)
+
+#define TESTER_INFO(id, ...) \
+    const auto XCONCAT(tester_info_, id) = \
+        [&](std::ostream& os) { os << __VA_ARGS__; }; \
+    const ::tester::scoped_trace XCONCAT(tester_trace_, id)( \
+        &XCONCAT(tester_info_, id), \
+        ::tester::trace_caller(XCONCAT(tester_info_, id)), NULL)
+#endif
+
+/* ************************************************************************ */
+
+namespace tester {
 
+/* ************************************************************************ */
+/* TYPES                                                                    */
 /* ************************************************************************ */
 
 /**
- * @brief Throws an exception when `res` is false.
- *
- * @param res    Evaluation result.
- * @param errstr Error string in the thrown exception.
- *
- * @throw assert_error If `res` is false.
+ * @brief Type that represents a point in time.
  */
-void test_assert(bool res, const std::string& errstr);
+#ifdef CXX11
+using time_point = std::chrono::high_resolution_clock::time_point;
+#else
+typedef std::clock_t time_point;
+#endif
 
 /* ************************************************************************ */
 
 /**
- * @brief Returns current time.
- *
- * @return Current time in undefined units.
+ * @brief Callback test function type.
  */
-time_point get_time();
+#ifdef CXX11
+using test_func = std::function<void()>;
+#else
+typedef void (*test_func)();
+#endif
 
 /* ************************************************************************ */
 
 /**
- * @brief Starts measuring tests run time.
- *
- * Resets statistical variables and error list.
+ * @brief Fuzz test function type.
  */
-void start();
+typedef void (*fuzz_func)(const unsigned char* data, std::size_t size);
 
 /* ************************************************************************ */
 
 /**
- * @brief Stops measuring tests run time.
+ * @brief List of failure records.
  */
-void stop();
+class error_list;
 
 /* ************************************************************************ */
 
 /**
- * @brief Prints testing results.
+ * @brief Failure kind.
+ */
+enum failure_kind
+{
+    /// Assertion failed.
+    failure_assert,
+
+    /// Test thrown an exception derived from std::exception.
+    failure_exception,
+
+    /// Test thrown an exception of unknown type.
+    failure_unknown
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Failure record.
  *
- * Prints testing statistics onto standard output.
+ * Record doesn't own any of the strings, they are stored in the error list
+ * arena or have static storage duration.
  */
-void print_results();
+struct error_record
+{
+    /// Failure kind.
+    failure_kind kind;
+
+    /// Interned test name.
+    const char* test;
+
+    /// Assertion location string or exception type name. Can be NULL.
+    const char* location;
+
+    /// Message slice (not zero terminated). Can be NULL.
+    const char* message;
+
+    /// Message slice length.
+    std::size_t length;
+};
 
 /* ************************************************************************ */
 
-}
+/**
+ * @brief Failure context frame.
+ *
+ * Frames are linked into a per-thread stack from the innermost scope and
+ * they're formatted only when an assertion fails.
+ */
+struct trace_frame
+{
+    /// Context data.
+    const void* data;
+
+    /// Prints context data.
+    void (*print)(std::ostream& os, const void* data);
+
+    /// Context label (static string). Can be NULL.
+    const char* label;
+
+    /// Enclosing frame. Can be NULL.
+    const trace_frame* prev;
+};
+
+/* ************************************************************************ */
+
+#ifdef CXX11
+
+/**
+ * @brief Thread of a stress test.
+ */
+struct stress_thread
+{
+    /// Thread index.
+    unsigned int index;
+
+    /// Number of threads.
+    unsigned int count;
+
+    /// Number of operations, incremented by the test body.
+    unsigned long long ops;
+
+    /// Stop flag set after the stress duration.
+    const std::atomic<bool>* stop;
+
+    /**
+     * @brief Returns if the body should continue.
+     *
+     * @return false after the stress duration.
+     */
+    bool running() const noexcept
+    {
+        return !stop->load(std::memory_order_relaxed);
+    }
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Stress test body type.
+ */
+using stress_func = std::function<void(stress_thread&)>;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Result of a stress test.
+ */
+struct stress_result
+{
+    /// Operations done by each thread.
+    std::vector<unsigned long long> ops;
+
+    /// Operations done by all threads.
+    unsigned long long total;
+
+    /// Time from the start of all threads to the end of the last one.
+    double seconds;
+
+    /// Operations per second.
+    double throughput;
+
+    /// Jain's fairness index of operations, 1 if all threads did the same.
+    double fairness;
+
+    /// Number of failures recorded by the threads.
+    unsigned int failures;
+};
+
+#endif
+
+/* ************************************************************************ */
+
+/**
+ * @brief Process resource usage.
+ *
+ * Values are zero where unsupported.
+ */
+struct resource_usage
+{
+    /// Peak resident set size in kB.
+    long max_rss;
+
+    /// Current resident set size in kB.
+    long rss;
+
+    /// Page faults without I/O.
+    long minor_faults;
+
+    /// Page faults with I/O.
+    long major_faults;
+
+    /// Voluntary context switches.
+    long voluntary_switches;
+
+    /// Involuntary context switches.
+    long involuntary_switches;
+};
+
+/* ************************************************************************ */
+/* VARIABLES                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Assertion counter of the current thread.
+ *
+ * Counters of threads started by run_stress() are added to the counter of
+ * the thread that started them.
+ */
+extern TESTER_THREAD_LOCAL unsigned int assertion_count;
+
+/* ************************************************************************ */
+
+/// Test counter.
+extern unsigned int test_count;
+
+/* ************************************************************************ */
+
+/// Failed test counter.
+extern unsigned int failed_count;
+
+/* ************************************************************************ */
+
+/// Skipped and disabled test counter.
+extern unsigned int skipped_count;
+
+/* ************************************************************************ */
+
+/// Quarantined test counter.
+extern unsigned int quarantine_count;
+
+/* ************************************************************************ */
+
+/// Failed quarantined test counter.
+extern unsigned int quarantine_failed_count;
+
+/* ************************************************************************ */
+
+/**
+ * @brief File with quarantined test paths. Empty if disabled.
+ *
+ * Each line contains a test path, names of nested tests are separated by
+ * `/`. Empty lines and lines starting with `#` are ignored. Quarantined
+ * tests are run in place. They and their child tests are counted by
+ * `quarantine_count` and their failures are stored in `quarantine_errors`
+ * so they don't affect the result.
+ */
+extern std::string quarantine_file;
+
+/* ************************************************************************ */
+
+/// Maximum number of stored expectation failures per test.
+extern unsigned int expect_limit;
+
+/* ************************************************************************ */
+
+/// Number of differing elements reported by array assertions.
+extern unsigned int array_report_limit;
+
+/* ************************************************************************ */
+
+/// If snapshot assertions rewrite golden files instead of testing.
+extern bool update_snapshots;
+
+/* ************************************************************************ */
+
+/**
+ * @brief If output of passing tests is dropped.
+ *
+ * Output written to std::cout by the thread running the test and output
+ * written to the standard output file descriptor (printf, write) is kept
+ * only for failed tests. Without it only std::cout output is captured and
+ * it's printed after the test result.
+ */
+extern bool capture_output;
+
+/* ************************************************************************ */
+
+/**
+ * @brief If progress of the run is displayed (C++11 only).
+ *
+ * On a terminal a status line with number of finished and failed tests,
+ * throughput, ETA and the running test is redrawn on stderr by a ticker
+ * thread. Top-level tests are then printed when they finish. Otherwise
+ * each test is printed when it finishes and a progress line is printed on
+ * stderr every 10 seconds.
+ */
+extern bool progress;
+
+/* ************************************************************************ */
+
+/**
+ * @brief File with test durations used for progress estimation.
+ *
+ * Durations of the previous run are read from it to estimate total number
+ * of tests and ETA, and durations of the current run are written into it.
+ * Empty to disable.
+ */
+extern std::string progress_file;
+
+/* ************************************************************************ */
+
+/**
+ * @brief If sibling tests are run in random order.
+ *
+ * Child tests are collected while the parent test body runs and they are
+ * run in random order after it, so code after their TEST_RUN runs before
+ * them. Only plain test functions are collected, other callables (e.g.
+ * lambdas capturing locals of the parent) are run in place.
+ */
+extern bool shuffle;
+
+/* ************************************************************************ */
+
+/// Seed of the random order, it's printed before tests.
+extern unsigned long shuffle_seed;
+
+/* ************************************************************************ */
+
+/**
+ * @brief If resource usage of each test is sampled.
+ *
+ * Tests with the highest usage are listed by print_results().
+ */
+extern bool sample_resources;
+
+/* ************************************************************************ */
+
+/// Number of tests in resource usage lists.
+extern unsigned int resource_top;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Number of processes replaying fuzz test corpus.
+ *
+ * Zero means number of processors. Corpus is replayed in the test process
+ * when it's one or when coverage is collected.
+ */
+extern unsigned int fuzz_jobs;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Path of the fuzz test run by libFuzzer. Empty in normal run.
+ *
+ * Fuzz test nested in other tests is selected by its path, names are
+ * separated by `/` (e.g. `group/name`). Bodies of tests on the path are
+ * called to reach it and their failures are ignored, other tests are
+ * skipped. The binary must be instrumented and linked with libFuzzer
+ * without its main function (`-fsanitize=fuzzer-no-link` and
+ * `libclang_rt.fuzzer_no_main`). Arguments that don't start with `--` are
+ * passed to libFuzzer.
+ */
+extern std::string fuzz_target;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Directory for per-test coverage data. Empty if disabled.
+ *
+ * In gcov instrumented binaries coverage counters are read and reset at
+ * test boundaries. `<coverage_dir>/coverage.txt` has
+ * one line per test with the index and IDs of functions executed by the
+ * test (without its child tests), `<coverage_dir>/tests.txt` maps indices
+ * to test paths and `<coverage_dir>/functions.txt` maps IDs to source
+ * locations and names. Index 0 contains code executed outside of tests.
+ * gcov builds have to define TESTER_GCOV. LLVM profiles are not supported
+ * because their counters can't be mapped to functions at runtime.
+ */
+extern std::string coverage_dir;
+
+/* ************************************************************************ */
+
+/// Innermost failure context frame of the current thread.
+extern TESTER_THREAD_LOCAL const trace_frame* trace_top;
+
+/* ************************************************************************ */
+
+/// Error list.
+extern error_list errors;
+
+/* ************************************************************************ */
+
+/// Failures of quarantined tests.
+extern error_list quarantine_errors;
+
+/* ************************************************************************ */
+
+/// Tests start time.
+extern time_point start_time;
+
+/* ************************************************************************ */
+
+/// Tests stop time.
+extern time_point stop_time;
+
+/* ************************************************************************ */
+/* CLASSES                                                                  */
+/* ************************************************************************ */
+
+/**
+ * @brief Assertion error.
+ *
+ * This exception type is used for indication the assertion failed.
+ */
+class assert_error : public std::runtime_error
+{
+
+// Public Ctors
+public:
+
+
+    /**
+     * @brief Creates an assertion error.
+     *
+     * @param what Error message.
+     */
+    explicit assert_error(const std::string& what)
+        : std::runtime_error(what)
+        , m_location(NULL)
+    {}
+
+
+    /**
+     * @brief Creates an assertion error.
+     *
+     * @param what Error message.
+     */
+    explicit assert_error(const char* what)
+        : std::runtime_error(what)
+        , m_location(NULL)
+    {}
+
+
+    /**
+     * @brief Creates an assertion error.
+     *
+     * Error message is the location followed by details.
+     *
+     * @param detail   Failure details. Can be empty.
+     * @param location Assertion location string with static storage
+     *                 duration. It's stored only as a pointer.
+     */
+    assert_error(const std::string& detail, const char* location)
+        : std::runtime_error(detail.empty()
+            ? std::string(location)
+            : std::string(location) + ": " + detail)
+        , m_location(location)
+    {}
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Returns assertion location string.
+     *
+     * @return Static location string or NULL.
+     */
+    const char* location() const noexcept
+    {
+        return m_location;
+    }
+
+
+    /**
+     * @brief Returns failure details.
+     *
+     * @return Part of the error message after location. Empty if the error
+     *         has no location.
+     */
+    const char* detail() const noexcept
+    {
+        if (!m_location)
+            return "";
+
+        const char* detail = what() + std::strlen(m_location);
+        return *detail ? detail + 2 : detail;
+    }
+
+
+// Private Data Members
+private:
+
+    /// Static location string.
+    const char* m_location;
+
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Skipped test signal.
+ *
+ * It's thrown by SKIP. It isn't derived from std::exception so tests that
+ * catch standard exceptions don't catch it.
+ */
+class skip_error
+{
+
+// Public Ctors
+public:
+
+
+    /**
+     * @brief Creates a skip signal.
+     *
+     * @param reason Static reason string.
+     */
+    explicit skip_error(const char* reason) noexcept
+        : m_reason(reason)
+    {}
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Returns skip reason.
+     *
+     * @return Skip reason.
+     */
+    const char* reason() const noexcept
+    {
+        return m_reason;
+    }
+
+
+// Private Data Members
+private:
+
+    /// Static reason string.
+    const char* m_reason;
+
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief Failure context guard.
+ *
+ * Pushes a frame onto the failure context stack of the current thread and
+ * pops it when destroyed. It's used by SCOPED_TRACE and INFO.
+ */
+class scoped_trace
+{
+
+// Public Ctors & Dtors
+public:
+
+
+    /**
+     * @brief Pushes a context frame.
+     *
+     * @param data  Context data, they must outlive the guard.
+     * @param print Function that prints the data.
+     * @param label Static label string. Can be NULL.
+     */
+    scoped_trace(const void* data, void (*print)(std::ostream&, const void*),
+        const char* label) noexcept
+    {
+        m_frame.data = data;
+        m_frame.print = print;
+        m_frame.label = label;
+        m_frame.prev = trace_top;
+        trace_top = &m_frame;
+    }
+
+
+    /**
+     * @brief Pops the context frame.
+     */
+    ~scoped_trace()
+    {
+        trace_top = m_frame.prev;
+    }
+
+
+// Private Ctors
+private:
+
+
+    /// Non-copyable.
+    scoped_trace(const scoped_trace&);
+
+
+    /// Non-assignable.
+    scoped_trace& operator=(const scoped_trace&);
+
+
+// Private Data Members
+private:
+
+    /// Context frame.
+    trace_frame m_frame;
+
+};
+
+/* ************************************************************************ */
+
+/**
+ * @brief List of failure records.
+ *
+ * Strings that have to be copied (test names, exception messages) are stored
+ * in an arena of memory blocks that is released only when the list is
+ * cleared. Test names are interned so each failing test name is stored only
+ * once. Messages are formatted only when they are printed.
+ */
+class error_list
+{
+
+// Public Types
+public:
+
+
+    /// Record iterator.
+    typedef std::vector<error_record>::const_iterator const_iterator;
+
+
+// Public Ctors & Dtors
+public:
+
+
+    /**
+     * @brief Creates an empty list.
+     */
+    error_list();
+
+
+    /**
+     * @brief Destructor.
+     */
+    ~error_list();
+
+
+// Public Accessors
+public:
+
+
+    /**
+     * @brief Returns if the list is empty.
+     *
+     * @return If the list is empty.
+     */
+    bool empty() const noexcept
+    {
+        return m_records.empty();
+    }
+
+
+    /**
+     * @brief Returns number of records.
+     *
+     * @return Number of records.
+     */
+    std::size_t size() const noexcept
+    {
+        return m_records.size();
+    }
+
+
+    /**
+     * @brief Returns record at given position.
+     *
+     * @param pos Record position.
+     *
+     * @return Record at given position.
+     */
+    const error_record& operator[](std::size_t pos) const noexcept
+    {
+        return m_records[pos];
+    }
+
+
+    /**
+     * @brief Returns iterator to the first record.
+     *
+     * @return Iterator to the first record.
+     */
+    const_iterator begin() const noexcept
+    {
+        return m_records.begin();
+    }
+
+
+    /**
+     * @brief Returns iterator after the last record.
+     *
+     * @return Iterator after the last record.
+     */
+    const_iterator end() const noexcept
+    {
+        return m_records.end();
+    }
+
+
+// Public Operations
+public:
+
+
+    /**
+     * @brief Adds a failure record.
+     *
+     * @param kind     Failure kind.
+     * @param test     Test name.
+     * @param location Static location string (not copied). Can be NULL.
+     * @param message  Message (copied). Can be NULL.
+     * @param length   Message length.
+     */
+    void add(failure_kind kind, const std::string& test, const char* location,
+        const char* message = NULL, std::size_t length = 0);
+
+
+    /**
+     * @brief Removes all records and releases the arena.
+     */
+    void clear() noexcept;
+
+
+    /**
+     * @brief Exchanges records with other list.
+     *
+     * @param other Other list.
+     */
+    void swap(error_list& other) noexcept;
+
+
+// Private Operations
+private:
+
+
+    /**
+     * @brief Copies a string into the arena.
+     *
+     * @param str String.
+     * @param len String length.
+     *
+     * @return Pointer to zero terminated copy.
+     */
+    const char* store(const char* str, std::size_t len);
+
+
+    /**
+     * @brief Returns interned copy of the test name.
+     *
+     * @param name Test name.
+     *
+     * @return Pointer to the arena.
+     */
+    const char* intern(const std::string& name);
+
+
+// Private Ctors
+private:
+
+
+    /// Non-copyable.
+    error_list(const error_list&);
+
+
+    /// Non-assignable.
+    error_list& operator=(const error_list&);
+
+
+// Private Data Members
+private:
+
+    /// Failure records.
+    std::vector<error_record> m_records;
+
+    /// Arena blocks.
+    std::vector<char*> m_blocks;
+
+    /// Used space in the last block.
+    std::size_t m_used;
+
+    /// Size of the last block.
+    std::size_t m_capacity;
+
+    /// Open addressing table of interned names.
+    std::vector<const char*> m_names;
+
+    /// Number of interned names.
+    std::size_t m_name_count;
+
+};
+
+/* ************************************************************************ */
+/* FUNCTIONS                                                                */
+/* ************************************************************************ */
+
+/**
+ * @brief Performs a test.
+ *
+ * Function calls given test function and prints it's call result onto
+ * standard output. The output have format where test name is printed and
+ * after that is printed the test result (OK or FAIL).
+ *
+ * Output written to std::cout by the thread running the test is printed
+ * after the result. Other threads write directly to the original output.
+ *
+ * Test can be called recursive and function is able to handle that. It's
+ * a simple way to group tests.
+ *
+ * @param test Pointer to test function. It can be lambda under C++11.
+ * @param name Test name.
+ *
+ * @see TEST_RUN
+ */
+void run_test(test_func test, const std::string& name) noexcept;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Performs a fuzz test.
+ *
+ * The test is run by run_test() with the empty input and each file of the
+ * corpus. All inputs are replayed even if some of them fail and failures
+ * contain the input path. On POSIX systems the corpus is split between
+ * `fuzz_jobs` processes so crashing inputs are reported too.
+ *
+ * When `fuzz_target` is set, the selected test is run by libFuzzer with
+ * the corpus directory and the process exits after it.
+ *
+ * @param test   Fuzz test function.
+ * @param name   Test name.
+ * @param corpus Corpus directory or a single input file.
+ *
+ * @see FUZZ_RUN
+ */
+void run_fuzz_test(fuzz_func test, const std::string& name, const std::string& corpus) noexcept;
+
+/* ************************************************************************ */
+
+#ifdef CXX11
+
+/**
+ * @brief Runs stress test body on multiple threads.
+ *
+ * Threads are started together from a spin barrier. Failures of all threads
+ * are recorded into the current test and the test continues. Operation
+ * counts, throughput and fairness are printed into the test output.
+ *
+ * @code
+ * TEST(queue)
+ * {
+ *     queue q;
+ *     const auto result = tester::run_stress([&](tester::stress_thread& t) {
+ *         for (; t.running(); ++t.ops)
+ *             ASSERT(q.push(t.index));
+ *     }, 4, true, 100);
+ *
+ *     ASSERT(result.fairness > 0.8);
+ * }
+ * @endcode
+ *
+ * @param body     Test body, called once on each thread.
+ * @param threads  Number of threads, 0 means number of processors.
+ * @param pin      If threads are pinned to processors (Linux only).
+ * @param duration Time in ms after that stress_thread::running() returns
+ *                 false, 0 means it always returns true.
+ *
+ * @return Stress test result.
+ */
+stress_result run_stress(const stress_func& body, unsigned int threads = 0,
+    bool pin = false, unsigned int duration = 0);
+
+#endif
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints test as skipped without running it.
+ *
+ * @param name   Test name.
+ * @param reason Static reason string.
+ *
+ * @see TEST_DISABLED
+ * @see TEST_RUN_IF
+ */
+void skip_test(const char* name, const char* reason) noexcept;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Stops the current test and marks it as skipped.
+ *
+ * Without exceptions the reason is stored into the current test and the
+ * caller returns.
+ *
+ * @param reason Static reason string.
+ *
+ * @return false.
+ *
+ * @throw skip_error Always.
+ */
+bool test_skip(const char* reason);
+
+/* ************************************************************************ */
+
+/**
+ * @brief Checks if two tests don't depend on their order.
+ *
+ * Tests are run in order first, second and then second, first. On POSIX
+ * systems each order is run in a forked process from the state before the
+ * check and its output is dropped, otherwise they're run as child tests of
+ * the current test. If a test result differs between orders, failure is
+ * recorded into the current test and the test continues.
+ *
+ * @param first       First test.
+ * @param first_name  First test name.
+ * @param second      Second test.
+ * @param second_name Second test name.
+ *
+ * @see TEST_ISOLATION
+ */
+void check_isolation(test_func first, const std::string& first_name,
+    test_func second, const std::string& second_name) noexcept;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Performs tests.
+ *
+ * This function handle the whole testing system and can be used as only one
+ * function call in the main function. The function calls sequentialy
+ * following functions:
+ *
+ *  - start()
+ *  - tests()
+ *  - stop()
+ *  - print_results()
+ *
+ * @param test A function that tests all required tests.
+ *
+ * @return Tests result. Can be used directly as program exit status.
+ */
+int run_tests(test_func tests) noexcept;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Performs tests with command line options.
+ *
+ * Same as run_tests(tests) but options are parsed by parse_args() first.
+ *
+ * @param argc  Number of arguments.
+ * @param argv  Arguments.
+ * @param tests A function that tests all required tests.
+ *
+ * @return Tests result. Can be used directly as program exit status.
+ */
+int run_tests(int argc, char** argv, test_func tests) noexcept;
+
+/* ************************************************************************ */
+
+/**
+ * @brief Parses command line options.
+ *
+ * Supported options:
+ *
+ *  - `--update-snapshots` Rewrite golden files of snapshot assertions.
+ *  - `--coverage=<dir>` Store per-test coverage data into directory.
+ *  - `--resources[=N]` Sample resource usage and list top N tests.
+ *  - `--shuffle[=seed]` Run sibling tests in random order.
+ *  - `--capture` Drop output of passing tests.
+ *  - `--progress[=file]` Display progress, durations are stored in file
+ *    (default `<program>.durations`).
+ *  - `--quarantine=<file>` Record failures of tests listed in file separately.
+ *  - `--jobs=N` Number of fuzz corpus replay processes.
+ *  - `--fuzz=<path>` Run fuzz test by libFuzzer.
+ *
+ * Unknown options are reported and ignored. In fuzzing mode they're passed
+ * to libFuzzer.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ */
+void parse_args(int argc, char** argv);
+
+/* ************************************************************************ */
+
+/**
+ * @brief Throws an exception when `res` is false.
+ *
+ * @param res    Evaluation result.
+ * @param errstr Error string in the thrown exception.
+ *
+ * @return `res`.
+ *
+ * @throw assert_error If `res` is false.
+ */
+bool test_assert(bool res, const std::string& errstr);
+
+/* ************************************************************************ */
+
+/**
+ * @brief Throws an assertion error.
+ *
+ * Without exceptions the failure is recorded into the current test.
+ *
+ * @param errstr Error string with static storage duration (string literal).
+ *
+ * @throw assert_error Always.
+ */
+void assert_failed(const char* errstr);
+
+/* ************************************************************************ */
+
+/**
+ * @brief Throws an exception when `res` is false.
+ *
+ * This version is used by ASSERT. It's inlined and doesn't construct any
+ * string when the assertion passes.
+ *
+ * @param res    Evaluation result.
+ * @param errstr Error string with static storage duration (string literal).
+ *
+ * @return `res`.
+ *
+ * @throw assert_error If `res` is false.
+ */
+inline bool test_assert(bool res, const char* errstr)
+{
+    if (res)
+        assertion_count++;
+    else
+        assert_failed(errstr);
+
+    return res;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Tests arrays equality.
+ *
+ * Overloads exist for all integer types, float and double.
+ *
+ * @param lhs    Left array.
+ * @param rhs    Right array.
+ * @param n      Number of elements.
+ * @param errstr Location string with static storage duration.
+ *
+ * @return If arrays are equal.
+ *
+ * @throw assert_error If arrays differ.
+ */
+bool test_array_eq(const char* lhs, const char* rhs, std::size_t n, const char* errstr);
+bool test_array_eq(const signed char* lhs, const signed char* rhs, std::size_t n, const char* errstr);
+bool test_array_eq(const unsigned char* lhs, const unsigned char* rhs, std::size_t n, const char* errstr);
+bool test_array_eq(const short* lhs, const short* rhs, std::size_t n, const char* errstr);
+bool test_array_eq(const unsigned short* lhs, const unsigned short* rhs, std::size_t n, const char* errstr);
+bool test_array_eq(const int* lhs, const int* rhs, std::size_t n, const char* errstr);
+bool test_array_eq(const unsigned int* lhs, const unsigned int* rhs, std::size_t n, const char* errstr);
+bool test_array_eq(const long* lhs, const long* rhs, std::size_t n, const char* errstr);
+bool test_array_eq(const unsigned long* lhs, const unsigned long* rhs, std::size_t n, const char* errstr);
+#ifdef CXX11
+bool test_array_eq(const long long* lhs, const long long* rhs, std::size_t n, const char* errstr);
+bool test_array_eq(const unsigned long long* lhs, const unsigned long long* rhs, std::size_t n, const char* errstr);
+#endif
+bool test_array_eq(const float* lhs, const float* rhs, std::size_t n, const char* errstr);
+bool test_array_eq(const double* lhs, const double* rhs, std::size_t n, const char* errstr);
+
+/* ************************************************************************ */
+
+/**
+ * @brief Tests if arrays are equal within tolerance.
+ *
+ * Elements are equal if they compare equal or their absolute difference is
+ * not greater than `tol`. NaN is never equal.
+ *
+ * @param lhs    Left array.
+ * @param rhs    Right array.
+ * @param n      Number of elements.
+ * @param tol    Tolerance.
+ * @param errstr Location string with static storage duration.
+ *
+ * @return If arrays are equal.
+ *
+ * @throw assert_error If arrays differ.
+ */
+bool test_array_near(const float* lhs, const float* rhs, std::size_t n, double tol, const char* errstr);
+bool test_array_near(const double* lhs, const double* rhs, std::size_t n, double tol, const char* errstr);
+
+/* ************************************************************************ */
+
+/**
+ * @brief Tests data against a golden file.
+ *
+ * The golden file is memory mapped and compared in chunks. On failure the
+ * first differing offset and line are reported with context. When
+ * `update_snapshots` is set the golden file is atomically replaced.
+ *
+ * @param data   Tested data.
+ * @param size   Data size.
+ * @param path   Golden file path.
+ * @param errstr Location string with static storage duration.
+ *
+ * @return If data are equal.
+ *
+ * @throw assert_error If data differ.
+ */
+bool test_snapshot(const void* data, std::size_t size, const std::string& path, const char* errstr);
+
+/* ************************************************************************ */
+
+/**
+ * @brief Tests string against a golden file.
+ *
+ * @param str    Tested string.
+ * @param path   Golden file path.
+ * @param errstr Location string with static storage duration.
+ *
+ * @return If data are equal.
+ *
+ * @throw assert_error If data differ.
+ */
+bool test_snapshot(const std::string& str, const std::string& path, const char* errstr);
+
+/* ************************************************************************ */
+
+/**
+ * @brief Sets resource budget of the current test.
+ *
+ * Usage is measured from this call to the end of the test. When it goes
+ * over the budget the test fails.
+ *
+ * @param memory   Maximum memory growth in kB, negative for unlimited.
+ * @param faults   Maximum number of page faults, negative for unlimited.
+ * @param switches Maximum number of context switches, negative for unlimited.
+ * @param errstr   Location string with static storage duration.
+ */
+void test_resource_budget(long memory, long faults, long switches, const char* errstr);
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns current resource usage of the process.
+ *
+ * @return Current resource usage of the process.
+ */
+resource_usage get_resource_usage();
+
+/* ************************************************************************ */
+
+/**
+ * @brief Records a failure of the current test when `res` is false.
+ *
+ * The test continues. When the current test already stored `expect_limit`
+ * failures, the failure is only counted.
+ *
+ * @param res    Evaluation result.
+ * @param errstr Error string.
+ */
+void test_expect(bool res, const std::string& errstr);
+
+/* ************************************************************************ */
+
+/**
+ * @brief Records a failure of the current test.
+ *
+ * @param errstr Error string with static storage duration (string literal).
+ */
+void expect_failed(const char* errstr);
+
+/* ************************************************************************ */
+
+/**
+ * @brief Records a failure of the current test when `res` is false.
+ *
+ * @param res    Evaluation result.
+ * @param errstr Error string with static storage duration (string literal).
+ */
+inline void test_expect(bool res, const char* errstr)
+{
+    if (res)
+        assertion_count++;
+    else
+        expect_failed(errstr);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints value of given type.
+ *
+ * @param os   Output stream.
+ * @param data Pointer to the value.
+ */
+template<typename T>
+void print_trace(std::ostream& os, const void* data)
+{
+    os << *static_cast<const T*>(data);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Calls function object of given type with the stream.
+ *
+ * @param os   Output stream.
+ * @param data Pointer to the function object.
+ */
+template<typename F>
+void call_trace(std::ostream& os, const void* data)
+{
+    (*static_cast<const F*>(data))(os);
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns pointer to the traced value.
+ *
+ * @param value Traced variable.
+ *
+ * @return Pointer to the traced value.
+ */
+template<typename T>
+inline const void* trace_data(const T& value) noexcept
+{
+    return &value;
+}
+
+#ifdef CXX11
+/// Temporary values would be destroyed before the failure.
+template<typename T>
+const void* trace_data(const T&& value) = delete;
+#endif
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns printing function for the traced value.
+ *
+ * @return Printing function for the traced value.
+ */
+template<typename T>
+inline void (*trace_printer(const T&))(std::ostream&, const void*)
+{
+    return &print_trace<T>;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns calling function for the traced function object.
+ *
+ * @return Calling function for the traced function object.
+ */
+template<typename F>
+inline void (*trace_caller(const F&))(std::ostream&, const void*)
+{
+    return &call_trace<F>;
+}
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints failure record.
+ *
+ * @param os     Output stream.
+ * @param record Failure record.
+ *
+ * @return os.
+ */
+std::ostream& operator<<(std::ostream& os, const error_record& record);
+
+/* ************************************************************************ */
+
+/**
+ * @brief Returns current time.
+ *
+ * @return Current time in undefined units.
+ */
+time_point get_time();
+
+/* ************************************************************************ */
+
+/**
+ * @brief Starts measuring tests run time.
+ *
+ * Resets statistical variables and error list. Starts collecting coverage
+ * when `coverage_dir` is set and displaying progress when `progress` is
+ * set. Buffer of `std::cout` is replaced by one that sends output of each
+ * thread running a test to that test.
+ */
+void start();
+
+/* ************************************************************************ */
+
+/**
+ * @brief Stops measuring tests run time.
+ *
+ * Stops collecting coverage and displaying progress. The original buffer
+ * of `std::cout` is restored.
+ */
+void stop();
+
+/* ************************************************************************ */
+
+/**
+ * @brief Prints testing results.
+ *
+ * Prints testing statistics onto standard output. When `sample_resources`
+ * is set, tests with the highest resource usage are listed.
+ */
+void print_results();
+
+/* ************************************************************************ */
+
+}
+
+/* ************************************************************************ */
+
+/**
+ * Header-only build. The implementation is compiled in the source file that
+ * defines TESTER_IMPLEMENTATION before including this header.
+ */
+#if defined(TESTER_HEADER_ONLY) && defined(TESTER_IMPLEMENTATION)
+#include "tester.cpp"
+#endif
 
 /* ************************************************************************ */
 